@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+// Structure for storing a snapshot of the global allocation counters
+struct AllocationSnapshot {
+    std::uint64_t allocations = 0;
+    std::uint64_t allocatedBytes = 0;
+    std::uint64_t liveBytes = 0;
+};
+
+// Check whether the converter was built with allocation accounting (TES3AB_ALLOCATION_STATS)
+bool allocationStatsEnabled();
+
+// Function to read the current allocation counters
+AllocationSnapshot allocationSnapshot();
+
+// Function to open a nested peak window; returns the outer peak that must be passed to endPeakWindow
+std::uint64_t beginPeakWindow();
+
+// Function to close a peak window; returns the peak live bytes seen inside it
+std::uint64_t endPeakWindow(std::uint64_t outerPeak);
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+// TES3 record header: name, data size, unused, flags; subrecord header: name, data size
+inline constexpr size_t RECORD_HEADER_SIZE = 16;
+inline constexpr size_t SUBRECORD_HEADER_SIZE = 8;
+
+// Function to read a little-endian 32-bit value
+inline std::uint32_t readLittleEndian32(const char* data) {
+    std::uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(data[i]);
+    }
+    return value;
+}
+
+// Function to append a little-endian value of the given byte width
+inline void appendLittleEndian(std::string& output, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        output += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+// Function to read a little-endian value of the given byte width at pos and advance past it; false if data ends first
+inline bool readLittleEndian(std::string_view data, size_t& pos, int bytes, std::uint64_t& value) {
+    if (pos > data.size() || data.size() - pos < static_cast<size_t>(bytes)) {
+        return false;
+    }
+    value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(data[pos + i]);
+    }
+    pos += bytes;
+    return true;
+}
+
+// Function to hash a block of bytes (FNV-1a 64-bit); pass the previous result to continue a hash
+std::uint64_t hashBytes(std::string_view data, std::uint64_t hash = 14695981039346656037ULL);
+
+// Function to read a whole file into memory
+bool readFileBytes(const std::filesystem::path& filePath, std::string& data);
+
+// Function to write a block of bytes to a file
+bool writeFileBytes(const std::filesystem::path& filePath, std::string_view data);
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ab_binary_io.h"
+
+// Structure for storing one replaced byte run: its offset in the source file and the bytes before and after
+struct PatchRun {
+    std::uint64_t offset = 0;
+    std::string oldBytes;
+    std::string newBytes;
+};
+
+// Structure for storing a binary patch between two plugin files; runs are sorted by offset and do not overlap.
+// Runs keep both the old and the new bytes, so the patch can be applied in either direction.
+struct BinaryPatch {
+    int conversionType = 0;
+    std::uint64_t sourceSize = 0;
+    std::uint64_t sourceHash = 0;
+    std::uint64_t targetSize = 0;
+    std::uint64_t targetHash = 0;
+    std::vector<PatchRun> runs;
+};
+
+// Function to build the patch turning one plugin file into another (diffed record by record and subrecord by subrecord)
+BinaryPatch buildBinaryPatch(std::string_view source, std::string_view target);
+
+// Function to build the patch that undoes a patch (offsets moved to the target, bytes, sizes, hashes and direction swapped)
+BinaryPatch invertBinaryPatch(const BinaryPatch& patch);
+
+// Function to apply a patch; fails unless the source and every run match the patch and the result matches the target hash
+bool applyBinaryPatch(std::string_view source, const BinaryPatch& patch, std::string& target, std::string& error);
+
+// Function to count the old and new bytes stored in the runs of a patch
+std::uint64_t binaryPatchPayload(const BinaryPatch& patch);
+
+// Function to convert a binary patch to its file format
+std::string serializeBinaryPatch(const BinaryPatch& patch);
+
+// Function to read a binary patch from its file format
+bool deserializeBinaryPatch(std::string_view data, BinaryPatch& patch, std::string& error);
+
+// Function to save a binary patch file
+bool saveBinaryPatch(const std::filesystem::path& patchPath, const BinaryPatch& patch, std::ofstream& logFile);
+
+// Function to load a binary patch file
+bool loadBinaryPatch(const std::filesystem::path& patchPath, BinaryPatch& patch, std::ofstream& logFile);
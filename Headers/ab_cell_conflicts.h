@@ -0,0 +1,88 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ab_coord_processor.h"
+
+// Record kinds a plugin can edit a grid cell with (bit flags)
+enum CellTouchKind : unsigned {
+    CELL_TOUCH_CELL = 1,
+    CELL_TOUCH_LANDSCAPE = 2,
+    CELL_TOUCH_PATHGRID = 4
+};
+
+// Structure for storing a grid cell moved by the conversion of one record
+struct CellTouch {
+    int gridX = 0;
+    int gridY = 0;
+    int newGridX = 0;
+    int newGridY = 0;
+    unsigned kinds = 0;
+    int conversionType = 0; // 1 = BM->AB, 2 = AB->BM; 0: the conversion of the file, set when the plugin is claimed
+};
+
+// Structure for storing one grid cell edited by more than one plugin in the same conversion direction
+struct CellConflict {
+    int conversionType = 0;
+    int gridX = 0;
+    int gridY = 0;
+    int newGridX = 0;
+    int newGridY = 0;
+    std::vector<std::pair<std::string, unsigned>> plugins;
+};
+
+// Function to describe the record kinds of a touch mask ("CELL, LAND, PGRD")
+std::string formatCellTouchKinds(unsigned kinds);
+
+// Shared grid cell -> plugins map filled while a batch is converted. The cells are spread over shards with their
+// own locks, and each plugin takes every shard lock at most once, so several threads can add plugins at the same time
+class CellConflictMap {
+public:
+    CellConflictMap() = default;
+
+    // Disable copy semantics
+    CellConflictMap(const CellConflictMap&) = delete;
+    CellConflictMap& operator=(const CellConflictMap&) = delete;
+
+    // Add the cells one converted plugin touched; touches without a conversion type take conversionType
+    void add(const std::string& pluginName, int conversionType, const std::vector<CellTouch>& touches);
+
+    // Get the cells touched by more than one plugin, sorted by direction and cell; plugins are listed in the order they
+    // were added
+    std::vector<CellConflict> conflicts() const;
+
+private:
+    static constexpr size_t SHARD_COUNT = 32;
+
+    // Structure for storing the plugins touching one cell
+    struct CellClaims {
+        int newGridX = 0;
+        int newGridY = 0;
+        std::vector<std::pair<size_t, unsigned>> plugins;
+    };
+
+    // Cells of one conversion direction
+    using DirectionCells = std::unordered_map<std::pair<int, int>, CellClaims, PairHash>;
+
+    // Structure for storing the cells of one shard behind their own lock, keyed by conversion direction
+    struct Shard {
+        mutable std::mutex mutex;
+        std::map<int, DirectionCells> cells;
+    };
+
+    static size_t shardOf(int conversionType, int gridX, int gridY);
+
+    std::array<Shard, SHARD_COUNT> shards_;
+    mutable std::mutex pluginsMutex_;
+    std::vector<std::string> plugins_;
+};
+
+// Function to log the cells edited by more than one plugin
+void logCellConflicts(const std::vector<CellConflict>& conflicts, std::ofstream& logFile);
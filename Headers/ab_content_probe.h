@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ab_coord_processor.h"
+
+// Result of probing a raw plugin for content the conversion could change
+enum class ProbeResult {
+    Relevant,           // something could match a mapping (the scan stops at the first match)
+    NothingToConvert,   // no record can match any mapping
+    Unknown             // not a TES3 plugin or malformed; let tes3conv decide
+};
+
+// Structure for storing the outcome of a probe and the first record that could be converted
+struct ContentProbe {
+    ProbeResult result = ProbeResult::Unknown;
+    std::string match;
+};
+
+// Function to scan a raw TES3 plugin, without decoding it, for anything the handlers could change with one of the
+// mappings: exterior cells, landscapes and path grids in a mapped cell, door and travel destinations into one, and
+// script or dialogue coordinate commands with coordinates in one (or coordinates that are not literal numbers)
+ContentProbe probePluginContent(std::string_view data, const std::vector<const CellMapping*>& mappings);
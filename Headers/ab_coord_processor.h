@@ -1,8 +1,13 @@
 #pragma once
+#include <cstdint>
+#include <filesystem>
 #include <iostream>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <utility>
 #include <string>
+#include <string_view>
 #include <fstream>
 
 #include <sqlite3.h>
@@ -24,15 +29,94 @@ struct GridOffset {
 // Function to determine GridOffsets based on conversion choice
 GridOffset getGridOffset(int conversionType);
 
-// Function to load custom grid coordinates
+// Function to load custom grid coordinates: the compiled cache next to the file is used while it matches the hash of
+// the text, otherwise the text is parsed (and the cache rewritten if updateCache is set)
 void loadCustomGridCoordinates(const std::string& filePath,
+    std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates,
+    bool updateCache, std::ofstream& logFile);
+
+// Function to parse the text of a custom grid coordinates file: one "X,Y" cell, "x1..x2,Y" / "X,y1..y2" range or
+// "x1..x2,y1..y2" rectangle per line, "//" starts a comment (a whole line or the rest of one)
+void parseCustomGridCoordinates(std::string_view text,
     std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates,
     std::ofstream& logFile);
 
-// Function to check if a given grid coordinate (gridX, gridY) is valid. It checks both the database and custom user-defined coordinates
-bool isCoordinateValid(const Database& db,
-    int gridX,
-    int gridY,
+// Function to get the compiled cache file of a custom grid coordinates file (same name, .cache extension)
+std::filesystem::path customCoordinatesCachePath(const std::string& filePath);
+
+// Function to convert expanded custom grid coordinates to the cache format
+std::string serializeCustomCoordinatesCache(const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates,
+    std::uint64_t textHash, std::uint64_t textSize);
+
+// Function to read expanded custom grid coordinates from the cache format; fails unless the cache was compiled from
+// a text file with the given hash and size
+bool deserializeCustomCoordinatesCache(std::string_view data, std::uint64_t textHash, std::uint64_t textSize,
+    std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates);
+
+// Structure for storing a single source cell -> destination cell entry
+struct CellMappingEntry {
+    int sourceX;
+    int sourceY;
+    int destX;
+    int destY;
+};
+
+// Source cell -> destination cell lookup, immutable after construction. A dense table over the bounding box of the
+// source cells gives O(1) lookups; mappings spread over an unreasonably large box fall back to a hash map
+class CellMapping {
+public:
+    CellMapping() = default;
+
+    // Constructor that builds the lookup (the first entry of a duplicated source cell wins)
+    explicit CellMapping(std::vector<CellMappingEntry> entries);
+
+    // Look up the destination cell of a source cell, returns false for cells that are not mapped
+    bool find(int gridX, int gridY, int& destX, int& destY) const {
+        std::int32_t slot = -1;
+        if (sparse_.empty()) {
+            std::int64_t column = static_cast<std::int64_t>(gridX) - minX_;
+            std::int64_t row = static_cast<std::int64_t>(gridY) - minY_;
+            if (column < 0 || row < 0 || column >= width_ || row >= height_) {
+                return false;
+            }
+            slot = slots_[static_cast<size_t>(row * width_ + column)];
+        }
+        else {
+            auto iter = sparse_.find({ gridX, gridY });
+            if (iter != sparse_.end()) slot = iter->second;
+        }
+        if (slot < 0) {
+            return false;
+        }
+        destX = entries_[slot].destX;
+        destY = entries_[slot].destY;
+        return true;
+    }
+
+    // Mapping in the opposite direction (for non-injective mappings the first source of a destination wins)
+    CellMapping inverted() const;
+
+    const std::vector<CellMappingEntry>& entries() const { return entries_; }
+    size_t size() const { return entries_.size(); }
+
+private:
+    std::vector<CellMappingEntry> entries_;
+    std::vector<std::int32_t> slots_;
+    std::unordered_map<std::pair<int, int>, std::int32_t, PairHash> sparse_;
+    std::int64_t minX_ = 0;
+    std::int64_t minY_ = 0;
+    std::int64_t width_ = 0;
+    std::int64_t height_ = 0;
+};
+
+// Function to build the built-in Anthology Bloodmoon profile: database and custom cells shifted by getGridOffset
+CellMapping buildAnthologyMapping(const Database& db,
     const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates,
-    const ProgramOptions& options,
-    std::ofstream& logFile);
\ No newline at end of file
+    int conversionType,
+    std::ofstream& logFile);
+
+// Function to load a mapping table (source X, source Y, destination X, destination Y per line) from a text file
+bool loadCellMappingFile(const std::string& filePath, std::vector<CellMappingEntry>& entries, std::ofstream& logFile);
+
+// Function to load a mapping table from the [tes3_ab_cell_mapping] table of a database
+bool loadCellMappingTable(const Database& db, std::vector<CellMappingEntry>& entries, std::ofstream& logFile);
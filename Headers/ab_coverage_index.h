@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ab_coord_processor.h"
+#include "ab_database.h"
+#include "ab_options.h"
+
+// Define the persistent cell-coverage index file, kept next to the coordinate database
+const std::string COVERAGE_INDEX_FILE = "tes3_ab_coverage_index.db";
+
+// Structure for storing the grid cells a plugin touches, by kind
+struct PluginCoverage {
+    std::string status;
+    std::set<std::pair<int, int>> cells;
+    std::set<std::pair<int, int>> landscapes;
+    std::set<std::pair<int, int>> pathGrids;
+    std::set<std::pair<int, int>> scriptCells;
+};
+
+// Function to collect the exterior cells, LAND and PGRD grids and script/dialogue coordinate cells of a decoded plugin;
+// status tells whether the converter would process it ("convertible", "already converted" or "missing Parent Masters")
+PluginCoverage collectPluginCoverage(const ordered_json& plugin);
+
+// Function to add the cells of the coordinate commands in a script or dialogue result; returns the number of commands
+// without literal coordinates
+size_t collectScriptCells(const std::string& text, std::set<std::pair<int, int>>& cells);
+
+// Structure for storing one plugin found by a coverage query
+struct CoverageMatch {
+    std::string path;
+    std::string status;
+    size_t cells = 0;
+    size_t landscapes = 0;
+    size_t pathGrids = 0;
+    size_t scriptCells = 0;
+    size_t mappedCells = 0;
+
+    // The converter would modify the plugin if it processes it and touches a mapped cell
+    bool wouldModify() const { return status == "convertible" && mappedCells > 0; }
+};
+
+// Persistent plugin -> touched cells index (SQLite). Coverage rows are keyed by content hash, plugin rows by path
+// with size and modification time, so re-indexing only decodes new or changed content
+class CoverageIndex {
+public:
+    // Constructor that opens or creates the index (throws std::runtime_error)
+    explicit CoverageIndex(const std::string& indexPath);
+
+    // Check whether a plugin is indexed with the given size and modification time
+    bool isCurrent(const std::filesystem::path& pluginPath, std::uint64_t size, std::int64_t modified) const;
+
+    // Point a plugin at content that is already indexed; returns false if the content hash is unknown
+    bool linkKnownContent(const std::filesystem::path& pluginPath, std::uint64_t size, std::int64_t modified, const std::string& contentHash);
+
+    // Store the coverage of new content and point the plugin at it
+    bool store(const std::filesystem::path& pluginPath, std::uint64_t size, std::int64_t modified, const std::string& contentHash,
+        const PluginCoverage& coverage);
+
+    // Remove plugins whose files no longer exist and coverage no plugin points at; returns the removed plugin count
+    size_t prune();
+
+    // Find the plugins touching any of the cells; mappedCells counts the touched cells the mapping would move
+    std::vector<CoverageMatch> query(const std::vector<std::pair<int, int>>& cells, const CellMapping& mapping) const;
+
+    // Number of indexed plugins
+    size_t pluginCount() const;
+
+private:
+
+    Database db_;
+};
+
+// Function to parse a coverage query: "region" (every cell the mapping moves) or "X,Y;X,Y;..." cells
+bool parseCoverageQuery(const std::string& spec, const CellMapping& mapping, std::vector<std::pair<int, int>>& cells, std::ofstream& logFile);
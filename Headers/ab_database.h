@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -35,4 +36,29 @@ private:
     };
 
     std::unique_ptr<sqlite3, Deleter> db_;
-};
\ No newline at end of file
+};
+
+// Prepared statement that is finalized when it goes out of scope
+class Statement {
+public:
+    // Constructor that prepares the statement (throws std::runtime_error)
+    Statement(sqlite3* db, const char* sql);
+    ~Statement() { sqlite3_finalize(stmt_); }
+
+    // Disable copy semantics
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+
+    void bind(int index, const std::string& value) { sqlite3_bind_text(stmt_, index, value.c_str(), -1, SQLITE_TRANSIENT); }
+    void bind(int index, std::int64_t value) { sqlite3_bind_int64(stmt_, index, value); }
+    void bindNull(int index) { sqlite3_bind_null(stmt_, index); }
+    int step() { return sqlite3_step(stmt_); }
+    void reset() { sqlite3_reset(stmt_); }
+    sqlite3_stmt* get() const { return stmt_; }
+
+private:
+    sqlite3_stmt* stmt_ = nullptr;
+};
+
+// Function to run a statement without results
+bool executeSql(sqlite3* db, const char* sql);
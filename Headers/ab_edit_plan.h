@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ab_binary_io.h"
+#include "ab_options.h"
+
+// Structure for storing a single edit: a record locator, a .JSON pointer inside the record and the old and new value.
+// Text edits only cover the changed part of a string, starting at offset (in the string before the edit).
+struct EditOperation {
+    size_t record = 0;
+    std::string type;
+    std::string id;
+    std::string path;
+    std::optional<size_t> offset;
+    ordered_json oldValue;
+    ordered_json newValue;
+};
+
+// Structure for storing the edits of a conversion together with the hashes of the files it reads and writes
+struct EditPlan {
+    int conversionType = 0;
+    std::string inputHash;
+    std::string outputHash;
+    std::vector<EditOperation> operations;
+};
+
+// Function to add the edits turning one record into another to the plan
+void addRecordEdits(EditPlan& plan, size_t recordIndex, const ordered_json& before, const ordered_json& after);
+
+// Function to build the edit plan between two versions of a plugin with the same records
+EditPlan buildEditPlan(const ordered_json& before, const ordered_json& after);
+
+// Function to build the plan that undoes a plan (old and new values, hashes and direction swapped)
+EditPlan invertEditPlan(const EditPlan& plan);
+
+// Function to apply a plan to a plugin; nothing is changed unless every edit matches the plugin
+bool applyEditPlan(ordered_json& plugin, const EditPlan& plan, std::string& error);
+
+// Function to convert an edit plan to .JSON
+ordered_json editPlanToJson(const EditPlan& plan);
+
+// Function to read an edit plan from .JSON
+bool editPlanFromJson(const ordered_json& planJson, EditPlan& plan, std::string& error);
+
+// Function to save an edit plan as a .JSON file
+bool saveEditPlan(const std::filesystem::path& planPath, const EditPlan& plan, std::ofstream& logFile);
+
+// Function to load an edit plan from a .JSON file
+bool loadEditPlan(const std::filesystem::path& planPath, EditPlan& plan, std::ofstream& logFile);
+
+// Function to hash the contents of a file (FNV-1a 64-bit, hex; empty if the file cannot be read)
+std::string hashFileContents(const std::filesystem::path& filePath);
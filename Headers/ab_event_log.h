@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "ab_options.h"
+
+// Structured event stream of the converter as .JSON Lines: one object per line with the run id, a sequence number, the
+// seconds since the run started, the event type, the current file and the fields of the event. The file is appended to
+// by every run and written through a buffer that is flushed after each plugin
+class EventLog {
+public:
+    // Constructor that opens the event file for appending (throws std::runtime_error)
+    explicit EventLog(const std::filesystem::path& eventPath);
+
+    // Destructor that writes out the buffered events
+    ~EventLog();
+
+    // Disable copy semantics
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    // Add an event; the fields are merged after the common ones
+    void emit(const char* type, ordered_json fields = ordered_json::object());
+
+    // Set the plugin the following events belong to (empty: none)
+    void setFile(const std::string& file) { file_ = file; }
+
+    // Write the buffered events to the file
+    void flush();
+
+    const std::string& runId() const { return runId_; }
+
+private:
+    std::ofstream output_;
+    std::string buffer_;
+    std::string runId_;
+    std::string file_;
+    std::uint64_t sequence_ = 0;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Set the event log the handlers and the logger of the calling thread report to (nullptr: none)
+void setEventLog(EventLog* events);
+
+// Get the active event log of the calling thread (nullptr when events are not recorded)
+EventLog* activeEventLog();
+
+// RAII scope that makes an event log active on the calling thread and restores the previous one; nullptr keeps it
+class EventLogScope {
+public:
+    explicit EventLogScope(EventLog* events) : previous_(activeEventLog()) {
+        if (events) setEventLog(events);
+    }
+    ~EventLogScope() { setEventLog(previous_); }
+
+    // Disable copy semantics
+    EventLogScope(const EventLogScope&) = delete;
+    EventLogScope& operator=(const EventLogScope&) = delete;
+
+private:
+    EventLog* previous_;
+};
+
+// Function to record a coordinate rewrite of a handler (kind: door, travel, script, dialogue, cell, landscape, pathgrid)
+// in the active event log; the record id is only read when events are recorded
+void logRewrite(const char* kind, const char* command, const ordered_json& record, int gridX, int gridY, int newGridX, int newGridY);
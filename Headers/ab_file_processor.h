@@ -4,6 +4,7 @@
 #include <fstream>
 
 #include "ab_options.h"
+#include "ab_process.h"
 
 // Function to check if file was already converted
 bool hasConversionTag(const ordered_json& inputData, const std::filesystem::path& filePath, std::ofstream& logFile);
@@ -15,10 +16,11 @@ std::pair<bool, std::unordered_set<int>> checkDependencyOrder(const ordered_json
 bool addConversionTag(ordered_json& inputData, const std::string& convPrefix, const ProgramOptions& options, std::ofstream& logFile);
 
 // Function to create backup with automatic numbering
-bool createBackup(const std::filesystem::path& filePath, const ProgramOptions& options, std::ofstream& logFile);
+bool createBackup(const std::filesystem::path& filePath, std::filesystem::path& backupPath, const ProgramOptions& options, std::ofstream& logFile);
 
 // Function to save the modified JSON data to file
 bool saveJsonToFile(const std::filesystem::path& jsonImportPath, const ordered_json& inputData, const ProgramOptions& options, std::ofstream& logFile);
 
 // Function to convert the .JSON file to .ESP|ESM
-bool convertJsonToEsp(const std::filesystem::path& jsonImportPath, const std::filesystem::path& espFilePath, const ProgramOptions& options, std::ofstream& logFile);
\ No newline at end of file
+bool convertJsonToEsp(const std::filesystem::path& jsonImportPath, const std::filesystem::path& espFilePath, ProcessResult& encodeResult,
+    const ProgramOptions& options, std::ofstream& logFile);
\ No newline at end of file
@@ -0,0 +1,150 @@
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ab_cell_conflicts.h"
+#include "ab_coord_processor.h"
+#include "ab_database.h"
+#include "ab_edit_plan.h"
+#include "ab_options.h"
+#include "ab_trace.h"
+
+// Embeddable conversion API (tes3ab library). Plugins are exchanged in the tes3conv .JSON layout.
+//
+// Thread safety: several threads may convert at once sharing one CoordinateIndex (read-only after setup).
+// - convertPlugin and convertPluginBuffer log to a closed stream and touch no shared state.
+// - Calls given an open log stream share the console and the log settings: set the level, categories and console
+//   output (ab_logger.h) before threads start, and do not log to the console from several threads at once.
+// - The event log is per thread (setEventLog), or per call with StageContext::events.
+
+// Coordinate index: the relocatable grid cells (SQLite database) plus the custom cells and the cell mappings
+// built from them for both conversion directions; set up once, then shared read-only
+class CoordinateIndex {
+public:
+    // Constructor that opens the database and loads the custom grid coordinates (throws std::runtime_error)
+    CoordinateIndex(const std::string& databasePath, const std::string& customCoordinatesPath);
+
+    // Constructor that takes over an already opened database and loaded custom grid coordinates
+    CoordinateIndex(Database&& db, std::unordered_set<std::pair<int, int>, PairHash>&& customCoordinates);
+
+    // Disable copy semantics
+    CoordinateIndex(const CoordinateIndex&) = delete;
+    CoordinateIndex& operator=(const CoordinateIndex&) = delete;
+
+    // Replace the built-in Anthology Bloodmoon profile with a mapping table (conversion type 1; type 2 uses its inverse)
+    void useMappingTable(std::vector<CellMappingEntry> entries);
+
+    // Cell mapping of a conversion type (1 = BM->AB, 2 = AB->BM)
+    const CellMapping& mapping(int conversionType) const { return conversionType == 2 ? reverse_ : forward_; }
+
+    const Database& database() const { return db_; }
+    const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates() const { return customCoordinates_; }
+
+private:
+    // Build the built-in profile for both directions
+    void buildAnthologyProfile();
+
+    Database db_;
+    std::unordered_set<std::pair<int, int>, PairHash> customCoordinates_;
+    CellMapping forward_;
+    CellMapping reverse_;
+};
+
+// Outcome of converting a single plugin
+enum class ConversionOutcome {
+    Converted,
+    AlreadyConverted,
+    MissingMasters,
+    NoReplacements,
+    NoHeaderDescription,
+    InvalidInput
+};
+
+// Function to get the report reason of an outcome ("converted" for success)
+const char* conversionOutcomeReason(ConversionOutcome outcome);
+
+// Structure for storing a record changed by the conversion
+struct RecordChange {
+    size_t index = 0;
+    std::string type;
+    std::string id;
+};
+
+// Structure for counting what a conversion changes, by kind
+struct ChangeSummary {
+    size_t cells = 0;
+    size_t landscapes = 0;
+    size_t pathGrids = 0;
+    size_t references = 0;
+    size_t doors = 0;
+    size_t travelDestinations = 0;
+    size_t scriptCommands = 0;
+    size_t dialogueCommands = 0;
+
+    ChangeSummary& operator+=(const ChangeSummary& other);
+};
+
+// Function to read the grid of a Cell, Landscape or PathGrid record ("grid" or "data.grid"); false if it has no integer grid
+bool readRecordGrid(const ordered_json& record, int& gridX, int& gridY);
+
+// Function to count the changes between two versions of a record (moved grids, references, door and travel
+// destinations, changed script and dialogue result lines)
+void addRecordChanges(ChangeSummary& summary, const ordered_json& before, const ordered_json& after);
+
+// Structure for storing the result of a buffer conversion
+struct ConversionResult {
+    ConversionOutcome outcome = ConversionOutcome::InvalidInput;
+    std::string error;
+    ordered_json plugin;
+    std::string buffer;
+    std::vector<std::string> updatedScriptIDs;
+    std::vector<RecordChange> changedRecords;
+    ChangeSummary changes;
+    EditPlan plan;
+
+    bool converted() const { return outcome == ConversionOutcome::Converted; }
+};
+
+// Function to convert a parsed plugin in place (checks, handlers and conversion tag), logging like the CLI does
+ConversionOutcome convertPluginData(ordered_json& plugin, const std::filesystem::path& pluginPath, const CoordinateIndex& index,
+    std::vector<std::string>& updatedScriptIDs, StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile);
+
+// Function to convert a parsed plugin in place with an explicit cell mapping (options.conversionType selects the conversion tag)
+ConversionOutcome convertPluginData(ordered_json& plugin, const std::filesystem::path& pluginPath, const CellMapping& mapping,
+    std::vector<std::string>& updatedScriptIDs, StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile);
+
+// Structure for storing a conversion profile: a conversion direction and the cell mapping it applies
+struct ConversionProfile {
+    std::string name;
+    int conversionType = 1;
+    std::shared_ptr<const CellMapping> mapping; // nullptr: the index mapping of conversionType
+};
+
+// Structure for storing the result of one profile; only changed records are stored, the rest stay shared with the input
+struct ProfileOutput {
+    ConversionOutcome outcome = ConversionOutcome::InvalidInput;
+    std::vector<std::string> updatedScriptIDs;
+    std::vector<std::pair<size_t, ordered_json>> records;
+    std::vector<CellTouch> touchedCells; // grid cells this profile moved, when the caller collects them
+};
+
+// Function to convert a parsed plugin for several profiles: one traversal picks the records the handlers can touch,
+// each profile converts its own copy of those and keeps the ones it changed
+std::vector<ProfileOutput> convertPluginProfiles(const ordered_json& plugin, const std::filesystem::path& pluginPath,
+    const CoordinateIndex& index, const std::vector<ConversionProfile>& profiles, StageContext& stageContext,
+    const ProgramOptions& options, std::ofstream& logFile);
+
+// Function to swap the records of a profile output into the plugin; swapping again restores the input
+void swapProfileRecords(ordered_json& plugin, ProfileOutput& output);
+
+// Function to convert a parsed plugin (conversionType 1 = BM->AB, 2 = AB->BM) without touching the input
+ConversionResult convertPlugin(const ordered_json& plugin, int conversionType, const CoordinateIndex& index);
+
+// Function to convert a raw tes3conv .JSON buffer; the converted buffer (empty unless converted) is serialized the way tes3conv receives it
+ConversionResult convertPluginBuffer(std::string_view buffer, int conversionType, const CoordinateIndex& index);
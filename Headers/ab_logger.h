@@ -1,13 +1,97 @@
 #pragma once
+#include <format>
 #include <fstream>
 #include <string>
 
+// Log levels, most severe first
+enum class LogLevel {
+    Error = 0,
+    Warn = 1,
+    Info = 2,
+    Debug = 3,     // every coordinate a handler finds and calculates
+    Trace = 4      // every reference of a moved cell
+};
+
+// Log categories (bit flags), enabled separately with --log-categories
+enum LogCategory : unsigned {
+    LOG_GENERAL = 1,
+    LOG_GRID = 2,
+    LOG_REFERENCES = 4,
+    LOG_DOORS = 8,
+    LOG_TRAVEL = 16,
+    LOG_SCRIPTS = 32,
+    LOG_DIALOGUE = 64,
+    LOG_ALL = 127
+};
+
+// Most verbose level compiled in (0 error ... 4 trace); set with the TES3AB_LOG_MAX_LEVEL CMake option
+#ifndef AB_LOG_MAX_LEVEL
+#define AB_LOG_MAX_LEVEL 4
+#endif
+
+// Runtime level and categories, read inline by every log call
+namespace log_settings {
+    inline LogLevel level = LogLevel::Info;
+    inline unsigned categories = LOG_ALL;
+}
+
+// Check if messages of a level and category are logged
+inline bool logEnabled(LogLevel level, unsigned category) {
+    return static_cast<int>(level) <= AB_LOG_MAX_LEVEL && level <= log_settings::level && (category & log_settings::categories) != 0;
+}
+
+// Log a std::format message at a level. The arguments are only evaluated when the level and category are enabled and
+// the log is open; levels above AB_LOG_MAX_LEVEL are discarded at compile time
+#define AB_LOG(level, category, logFile, ...)                                   \
+    do {                                                                        \
+        if constexpr (static_cast<int>(level) <= AB_LOG_MAX_LEVEL) {            \
+            if (logEnabled(level, category) && (logFile).is_open()) {           \
+                logMessage(std::format(__VA_ARGS__), logFile);                  \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+#define AB_LOG_ERROR(category, logFile, ...) AB_LOG(LogLevel::Error, category, logFile, __VA_ARGS__)
+#define AB_LOG_WARN(category, logFile, ...) AB_LOG(LogLevel::Warn, category, logFile, __VA_ARGS__)
+#define AB_LOG_INFO(category, logFile, ...) AB_LOG(LogLevel::Info, category, logFile, __VA_ARGS__)
+#define AB_LOG_DEBUG(category, logFile, ...) AB_LOG(LogLevel::Debug, category, logFile, __VA_ARGS__)
+#define AB_LOG_TRACE(category, logFile, ...) AB_LOG(LogLevel::Trace, category, logFile, __VA_ARGS__)
+
+// Where logMessage writes besides the log file
+enum class ConsoleOutput {
+    All,            // every message (default)
+    WarningsOnly    // only warnings and errors; the console shows the progress line
+};
+
 // Log messages to both a log file and console
 void logMessage(const std::string& message, std::ofstream& logFile);
 
+// Set the most verbose level that is logged
+void setLogLevel(LogLevel level);
+
+// Set the categories that are logged (LogCategory flags)
+void setLogCategories(unsigned categories);
+
+// Read a level name (error, warn, info, debug, trace)
+bool parseLogLevel(const std::string& name, LogLevel& level);
+
+// Read a comma-separated list of category names (general, grid, references, doors, travel, scripts, dialogue, all)
+bool parseLogCategories(const std::string& list, unsigned& categories);
+
+// Choose which messages reach the console
+void setConsoleOutput(ConsoleOutput output);
+
+// Check if the console is an interactive terminal
+bool consoleIsTerminal();
+
+// Show a status line on the console; it is redrawn in place below the messages until logStatusEnd
+void logStatus(const std::string& status);
+
+// End the status line, leaving its last state on the console
+void logStatusEnd();
+
 // Clear log file
 void logClear();
 
 // Log errors, close the database and terminate the program
 [[noreturn]] void logErrorAndExit(const std::string& errorMessage, std::ofstream& logFile);
-
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "ab_options.h"
+
+// Structure for storing one plugin of a batch manifest and the settings it overrides
+struct ManifestEntry {
+    std::filesystem::path path;
+    size_t line = 0;
+    int conversionType = 0; // 0: the conversion of the run
+    std::optional<bool> savePlan;
+    std::optional<bool> savePatch;
+    std::optional<bool> probe;
+};
+
+// Function to apply the overrides of a manifest entry to the options of its file
+void applyManifestEntry(ProgramOptions& options, const ManifestEntry& entry);
+
+// Function to write a manifest entry as a .JSON manifest line (the object form read by ManifestReader)
+ordered_json manifestEntryToJson(const ManifestEntry& entry);
+
+// Streaming reader of a batch manifest. Each line is either a .JSON object
+//   {"path": "Data Files/mod.esp", "conversion": "bm-to-ab", "save_plan": true, "save_patch": false, "probe": false}
+// or plain text: path[;conversion[;option...]] with conversion bm-to-ab|ab-to-bm|1|2 and options save-plan, save-patch,
+// no-probe. Empty lines and lines starting with # are skipped. Directories are walked recursively as they are reached,
+// so neither the manifest nor a directory is ever held in memory as a whole.
+class ManifestReader {
+public:
+    // Constructor that opens the manifest (throws std::runtime_error)
+    explicit ManifestReader(const std::filesystem::path& manifestPath);
+
+    // Disable copy semantics
+    ManifestReader(const ManifestReader&) = delete;
+    ManifestReader& operator=(const ManifestReader&) = delete;
+
+    // Read the next plugin; returns false at the end of the manifest. Invalid lines are logged and skipped
+    bool next(ManifestEntry& entry, std::ofstream& logFile);
+
+    size_t linesRead() const { return lineNumber_; }
+    size_t linesSkipped() const { return skipped_; }
+
+private:
+    // Parse one line; returns false (with the reason) if it is invalid
+    bool parseLine(const std::string& line, ManifestEntry& entry, std::string& error) const;
+
+    std::ifstream input_;
+    size_t lineNumber_ = 0;
+    size_t skipped_ = 0;
+    std::filesystem::recursive_directory_iterator directory_;
+    ManifestEntry directoryEntry_;
+};
+
+// Function to count the plugins a manifest names, directories included, without keeping them (0 if it cannot be read)
+size_t countManifestPlugins(const std::filesystem::path& manifestPath);
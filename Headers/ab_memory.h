@@ -0,0 +1,5 @@
+#pragma once
+#include <cstdint>
+
+// Function to read the current resident set size of this process in bytes (0 when unsupported)
+std::uint64_t readCurrentRss();
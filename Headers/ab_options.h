@@ -27,6 +27,31 @@ struct ProgramOptions {
     bool silentMode = false;
     std::vector<std::filesystem::path> inputFiles;
     int conversionType = 0;
+    std::filesystem::path reportFile;
+    std::filesystem::path traceFile;
+    std::filesystem::path eventFile;
+    std::filesystem::path mappingFile;
+    std::vector<std::string> profileSpecs;
+    bool savePlan = false;
+    std::filesystem::path applyPlanFile;
+    std::filesystem::path revertPlanFile;
+    bool savePatch = false;
+    std::filesystem::path applyPatchFile;
+    std::filesystem::path revertPatchFile;
+    bool dryRun = false;
+    bool buildIndex = false;
+    std::string indexQuery;
+    std::filesystem::path manifestFile;
+    std::filesystem::path shardInitDir;
+    std::filesystem::path shardDir;
+    std::filesystem::path shardFinalizeDir;
+    std::string claimTimeout;
+    bool incremental = false;
+    bool noProbe = false;
+    bool progress = false;
+    std::string logLevel;
+    std::string logCategories;
+    bool perfCounters = false;
 };
 
 // Function to parse command-line arguments
@@ -0,0 +1,42 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Number of hardware counters recorded around each stage
+constexpr int PERF_COUNTER_COUNT = 5;
+
+// Structure for storing a reading of all hardware counters
+struct PerfCounterValues {
+    std::array<std::uint64_t, PERF_COUNTER_COUNT> values{};
+};
+
+// Hardware performance counters of the calling thread (Linux perf_event_open); unavailable counters read as zero
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    // Disable copy semantics
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Check whether at least one counter could be opened
+    bool available() const;
+
+    // Check whether a particular counter could be opened
+    bool available(int index) const;
+
+    // Reason why counters are unavailable (empty when all counters opened)
+    const std::string& error() const { return error_; }
+
+    // Read the current (multiplexing-scaled) values of all counters
+    PerfCounterValues read() const;
+
+    // Name of the counter at the given index, as used in the report
+    static const char* counterName(int index);
+
+private:
+    std::array<int, PERF_COUNTER_COUNT> fds_;
+    std::string error_;
+};
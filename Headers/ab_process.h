@@ -0,0 +1,43 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Structure for storing resource usage of finished tes3conv child processes
+struct ChildUsage {
+    int runs = 0;
+    double wallSeconds = 0.0;
+    double userSeconds = 0.0;
+    double systemSeconds = 0.0;
+    long long maxRssKB = 0;
+    long long blockInputOps = 0;
+    long long blockOutputOps = 0;
+
+    // Accumulate usage of another child (max RSS is kept as the peak value)
+    ChildUsage& operator+=(const ChildUsage& other);
+};
+
+// Structure for storing the result of a child process run
+struct ProcessResult {
+    bool started = false;
+    int exitCode = -1;
+    long long processId = 0;
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point endTime;
+    ChildUsage usage;
+};
+
+// Function to get the id of the current process
+long long currentProcessId();
+
+// Function to run an external program, wait for it and collect its resource usage
+// (an empty working directory keeps the current one, an empty output path keeps the console)
+ProcessResult runProcess(const std::vector<std::string>& arguments, const std::filesystem::path& workingDirectory = {},
+    const std::filesystem::path& outputPath = {});
+
+// Function to run tes3conv for converting between .ESP|ESM and .JSON
+ProcessResult runTes3conv(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath);
+
+// Function to format child usage as a single log line
+std::string formatChildUsage(const ChildUsage& usage);
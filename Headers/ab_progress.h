@@ -0,0 +1,44 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Single console status line of a batch: files done/total, records/s, MB/s and ETA. Updates are rate-limited (a few
+// per second on a terminal, one every few seconds when the console is redirected)
+class ProgressLine {
+public:
+    // Constructor for a batch of known size (0 files: size unknown, no ETA; 0 bytes: ETA from the files done)
+    ProgressLine(size_t totalFiles, std::uint64_t totalBytes);
+
+    // Read the files of the batch done so far from a shared source (the job directory of shard workers) instead of
+    // counting the files of this process; it is only called when the line is drawn
+    void setBatchDone(std::function<size_t()> batchDone);
+
+    // Draw the first state of the line
+    void fileStarted();
+
+    // Count a processed file with its size and number of records
+    void fileFinished(std::uint64_t bytes, size_t records);
+
+    // Draw the final state and release the console
+    void finish();
+
+private:
+    // Draw the status line if the last update is old enough (or always when forced)
+    void render(bool force);
+
+    using Clock = std::chrono::steady_clock;
+
+    size_t totalFiles_;
+    std::uint64_t totalBytes_;
+    size_t filesDone_ = 0;
+    std::uint64_t bytesDone_ = 0;
+    size_t recordsDone_ = 0;
+    std::function<size_t()> batchDone_;
+    size_t batchDoneAtStart_ = 0;
+    Clock::time_point start_;
+    Clock::time_point lastRender_;
+    Clock::duration interval_;
+    bool rendered_ = false;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ab_coord_processor.h"
+#include "ab_database.h"
+#include "ab_library.h"
+#include "ab_options.h"
+#include "ab_trace.h"
+
+// Define the persistent record cache file, kept next to the coordinate database
+const std::string RECORD_CACHE_FILE = "tes3_ab_record_cache.db";
+
+// Structure for counting the records of a plugin that were looked up in the record cache and reused from it
+struct RecordCacheStats {
+    size_t records = 0;
+    size_t reused = 0;
+
+    RecordCacheStats& operator+=(const RecordCacheStats& other);
+
+    // Share of the records reused from the cache (0 when nothing was looked up)
+    double reuseRatio() const { return records > 0 ? static_cast<double>(reused) / static_cast<double>(records) : 0.0; }
+};
+
+// Structure for storing the key of a record version: hash and size of its .JSON text
+struct RecordKey {
+    std::uint64_t hash = 0;
+    std::uint64_t size = 0;
+
+    bool operator==(const RecordKey& other) const { return hash == other.hash && size == other.size; }
+};
+
+// Hash function for record keys
+struct RecordKeyHash {
+    std::size_t operator()(const RecordKey& key) const { return static_cast<std::size_t>(key.hash ^ (key.size * 0x9E3779B97F4A7C15ULL)); }
+};
+
+// Function to fingerprint a conversion (direction and every mapped cell), so records are only reused for the same conversion
+std::string conversionFingerprint(const CellMapping& mapping, int conversionType);
+
+// Persistent record cache (SQLite): per plugin name and conversion, the records of the last converted version keyed by
+// the hash of their text, with the converted text of the records the handlers changed (empty for unchanged records)
+class RecordCache {
+public:
+    // Constructor that opens or creates the cache for one conversion (throws std::runtime_error)
+    RecordCache(const std::string& cachePath, std::string conversionKey);
+
+    // Load the cached records of a plugin
+    bool load(const std::string& pluginKey, std::unordered_map<RecordKey, std::string, RecordKeyHash>& records) const;
+
+    // Replace the cached records of a plugin with those of its current version
+    bool store(const std::string& pluginKey, const std::vector<std::pair<RecordKey, std::string>>& records);
+
+private:
+
+    Database db_;
+    std::string conversionKey_;
+};
+
+// Function to convert a parsed plugin in place, running the handlers only on the records that changed since the cached
+// version of the plugin and reusing the cached result for the rest; the cache is updated unless the plugin is skipped
+// before the handlers run
+ConversionOutcome convertPluginIncremental(ordered_json& plugin, const std::filesystem::path& pluginPath, const CellMapping& mapping,
+    RecordCache& cache, RecordCacheStats& stats, std::vector<std::string>& updatedScriptIDs, StageContext& stageContext,
+    const ProgramOptions& options, std::ofstream& logFile);
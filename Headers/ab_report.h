@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ab_cell_conflicts.h"
+#include "ab_library.h"
+#include "ab_options.h"
+#include "ab_process.h"
+#include "ab_record_cache.h"
+#include "ab_trace.h"
+
+// Structure for storing the outcome and timings of a single processed file
+struct FileReport {
+    std::filesystem::path path;
+    std::string status = "failed";
+    std::string reason;
+    int conversionType = 0; // set when a manifest line chooses the conversion of this file
+    double totalSeconds = 0.0;
+    double inProcessSeconds = 0.0;
+    std::uint64_t inputBytes = 0;
+    std::size_t recordCount = 0;
+    std::uint64_t baselineRssBytes = 0;
+    std::uint64_t peakRssBytes = 0;
+    ChildUsage decode;
+    ChildUsage encode;
+    std::map<std::string, StageStats> stages;
+    std::vector<std::pair<std::string, std::string>> profiles;
+    ChangeSummary changes;
+    RecordCacheStats recordCache;
+};
+
+// Structure for storing the running totals of the files of a run
+struct RunTotals {
+    size_t files = 0;
+    std::map<std::string, size_t> statuses;
+    double inProcessSeconds = 0.0;
+    std::uint64_t inputBytes = 0;
+    std::size_t recordCount = 0;
+    std::uint64_t peakRssBytes = 0;
+    double worstRssPerInputMB = 0.0;
+    std::filesystem::path worstRssPath; // empty: no file with a known input size
+    ChildUsage decode;
+    ChildUsage encode;
+    std::map<std::string, StageStats> stages;
+    ChangeSummary changes;
+    RecordCacheStats recordCache;
+
+    size_t count(const std::string& status) const;
+};
+
+// Structure for storing the outcome and timings of a whole run. The totals cover every file; the files themselves are
+// only kept when they are written to a report (keepFiles), so long batches do not pile them up in memory
+struct RunReport {
+    int conversionType = 0;
+    bool dryRun = false;
+    bool incremental = false;
+    bool keepFiles = true;
+    double totalSeconds = 0.0;
+    const PerfCounters* perfCounters = nullptr;
+    RunTotals totals;
+    std::vector<FileReport> files;
+    std::vector<CellConflict> cellConflicts;
+};
+
+// Function to add a processed file to the totals of a run, and to its files if they are kept
+void addFileReport(RunReport& report, FileReport&& fileReport);
+
+// Function to split the file time into in-process and tes3conv time
+void finalizeFileReport(FileReport& fileReport, double totalSeconds);
+
+// Function to get the peak memory of a file per MB of input (0 when unknown)
+double rssPerInputMB(const FileReport& fileReport);
+
+// Function to log the timings of a single converted file
+void logFileTimings(const FileReport& fileReport, std::ofstream& logFile);
+
+// Function to describe a change summary in one line
+std::string formatChangeSummary(const ChangeSummary& changes);
+
+// Function to log the per-batch timing summary
+void logRunSummary(const RunReport& report, std::ofstream& logFile);
+
+// Function to describe one file of a run as .JSON
+ordered_json fileReportToJson(const FileReport& file, const RunReport& report);
+
+// Function to write the machine-readable run report as .JSON
+bool writeRunReport(const std::filesystem::path& reportPath, const RunReport& report, std::ofstream& logFile);
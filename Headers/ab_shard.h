@@ -0,0 +1,83 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ab_manifest.h"
+#include "ab_options.h"
+
+// Default time after which the claim of a worker that stopped refreshing it is given back to the queue
+const std::chrono::seconds DEFAULT_CLAIM_TIMEOUT{ 300 };
+
+// Function to create the job directory of a sharded batch; fails if it already holds jobs. Layout:
+//   queue/    one <n>.job file per plugin (a .JSON manifest line), waiting to be claimed
+//   claimed/  jobs being processed, renamed to <n>.job.<worker>; the worker refreshes the file time while it works
+//   done/     finished jobs
+//   results/  the report entry of each finished job (<n>.json)
+bool initShardJobDirectory(const std::filesystem::path& jobDir, std::ofstream& logFile);
+
+// Function to add one plugin to the queue of a job directory
+bool addShardJob(const std::filesystem::path& jobDir, size_t jobNumber, const ManifestEntry& entry, std::ofstream& logFile);
+
+// Worker of a sharded batch. Jobs are claimed by renaming them from queue/ to claimed/, which only one process can do;
+// claims that were not refreshed within the timeout (the worker was killed) are moved back to the queue
+class ShardWorker {
+public:
+    // Constructor that joins a job directory (throws std::runtime_error)
+    ShardWorker(const std::filesystem::path& jobDir, std::chrono::seconds claimTimeout);
+
+    // Destructor that stops refreshing the claims
+    ~ShardWorker();
+
+    // Disable copy semantics
+    ShardWorker(const ShardWorker&) = delete;
+    ShardWorker& operator=(const ShardWorker&) = delete;
+
+    // Claim the next job; waits while other workers still hold claims and returns false once every job is done
+    bool claim(ManifestEntry& entry, std::ofstream& logFile);
+
+    // Store the report entry of the claimed job and mark it as done
+    void complete(ordered_json result, std::ofstream& logFile);
+
+    // Count the jobs of the batch (queued, claimed and done) and the jobs done by every worker
+    size_t jobCount() const;
+    size_t jobsFinished() const;
+
+    const std::string& workerId() const { return workerId_; }
+    size_t jobsDone() const { return jobsDone_; }
+    size_t claimsRequeued() const { return requeued_; }
+
+private:
+    // Move expired claims of other workers back to the queue
+    void requeueExpiredClaims(std::ofstream& logFile);
+
+    // Read the names of the queued jobs, in order
+    void listQueue();
+
+    // Refresh the file time of the current claim until the worker stops
+    void heartbeat();
+
+    std::filesystem::path jobDir_;
+    std::chrono::seconds claimTimeout_;
+    std::string workerId_;
+    std::vector<std::string> pending_;
+    size_t nextPending_ = 0;
+    std::string currentJob_;
+    size_t jobsDone_ = 0;
+    size_t requeued_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::filesystem::path currentClaim_;
+    bool stopping_ = false;
+    std::thread heartbeat_;
+};
+
+// Function to merge the results of all workers into one .JSON report; jobs still queued or claimed are counted
+bool mergeShardResults(const std::filesystem::path& jobDir, const std::filesystem::path& reportPath, std::ofstream& logFile);
@@ -0,0 +1,105 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ab_perf_counters.h"
+#include "ab_process.h"
+
+struct CellTouch;
+class EventLog;
+
+// Structure for storing a single Chrome trace "complete" event
+struct TraceEvent {
+    std::string name;
+    std::string category;
+    std::string fileName;
+    long long startMicros = 0;
+    long long durationMicros = 0;
+    long long processId = 0;
+    long long threadId = 0;
+};
+
+// Collector of trace events, written as Chrome/Perfetto trace-event .JSON at the end of the run
+class TraceRecorder {
+public:
+    TraceRecorder();
+
+    // Disable copy semantics
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // Record a finished span; processId 0 means this process
+    void addSpan(const std::string& name, const std::string& category, const std::string& fileName,
+        std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end, long long processId = 0);
+
+    // Write all recorded events to the trace file
+    bool writeToFile(const std::filesystem::path& tracePath, std::ofstream& logFile) const;
+
+private:
+    std::chrono::steady_clock::time_point origin_;
+    long long processId_;
+    mutable std::mutex mutex_;
+    std::vector<TraceEvent> events_;
+};
+
+// Structure for storing the accumulated cost of a pipeline stage or handler
+struct StageStats {
+    int calls = 0;
+    double seconds = 0.0;
+    std::uint64_t allocations = 0;
+    std::uint64_t allocatedBytes = 0;
+    std::uint64_t peakLiveBytes = 0;
+    std::array<std::uint64_t, PERF_COUNTER_COUNT> perfCounts{};
+
+    // Accumulate another stage measurement (peak live bytes is kept as the peak value)
+    StageStats& operator+=(const StageStats& other);
+};
+
+// Structure for storing the per-file instrumentation context shared by all stages of a file
+struct StageContext {
+    TraceRecorder* tracer = nullptr;
+    std::string fileName;
+    std::map<std::string, StageStats>* stages = nullptr;
+    const PerfCounters* perfCounters = nullptr;
+    std::uint64_t* peakRssBytes = nullptr;
+    std::vector<CellTouch>* touchedCells = nullptr; // grid cells moved by the handlers, when collected
+    EventLog* events = nullptr;                     // event log of this call, instead of the thread's active one
+};
+
+// RAII span around a pipeline stage; does nothing when no instrumentation is enabled
+class StageScope {
+public:
+    StageScope(StageContext& context, const char* name, const char* category);
+    ~StageScope();
+
+    // End the stage before the scope ends
+    void finish();
+
+    // Disable copy semantics
+    StageScope(const StageScope&) = delete;
+    StageScope& operator=(const StageScope&) = delete;
+
+private:
+    // Sample the resident set size at a stage boundary and keep the peak
+    void sampleRss();
+
+    StageContext& context_;
+    const char* name_;
+    const char* category_;
+    bool active_;
+    std::chrono::steady_clock::time_point start_;
+    std::uint64_t startAllocations_ = 0;
+    std::uint64_t startAllocatedBytes_ = 0;
+    std::uint64_t outerPeak_ = 0;
+    PerfCounterValues startCounters_;
+};
+
+// Function to record a finished tes3conv run on its own child process track
+void traceChildProcess(StageContext& context, const char* name, const ProcessResult& result);
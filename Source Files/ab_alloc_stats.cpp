@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "ab_alloc_stats.h"
+
+#ifdef AB_ALLOCATION_STATS
+
+// Global counters; relaxed ordering is enough, they are only read for reporting
+static std::atomic<std::uint64_t> allocationCount{ 0 };
+static std::atomic<std::uint64_t> allocatedByteCount{ 0 };
+static std::atomic<std::uint64_t> liveByteCount{ 0 };
+static std::atomic<std::uint64_t> peakLiveByteCount{ 0 };
+
+// Every block carries its size in a header, so plain delete can account for it
+static constexpr std::size_t allocationHeaderSize = alignof(std::max_align_t) > sizeof(std::size_t)
+    ? alignof(std::max_align_t) : sizeof(std::size_t);
+
+// Helper function to raise the peak live bytes to the given value
+static void updatePeak(std::uint64_t live) {
+    std::uint64_t peak = peakLiveByteCount.load(std::memory_order_relaxed);
+    while (live > peak && !peakLiveByteCount.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+// Helper function to allocate a counted block
+static void* countedAllocate(std::size_t size) noexcept {
+    void* raw = std::malloc(size + allocationHeaderSize);
+    if (raw == nullptr) {
+        return nullptr;
+    }
+    *static_cast<std::size_t*>(raw) = size;
+
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedByteCount.fetch_add(size, std::memory_order_relaxed);
+    updatePeak(liveByteCount.fetch_add(size, std::memory_order_relaxed) + size);
+
+    return static_cast<char*>(raw) + allocationHeaderSize;
+}
+
+// Helper function to free a counted block
+static void countedFree(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    void* raw = static_cast<char*>(pointer) - allocationHeaderSize;
+    liveByteCount.fetch_sub(*static_cast<std::size_t*>(raw), std::memory_order_relaxed);
+    std::free(raw);
+}
+
+// Helper function to allocate or throw, as required from operator new
+static void* countedAllocateOrThrow(std::size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        if (void* pointer = countedAllocate(size)) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+// Replacements of the global allocation functions; nlohmann::ordered_json uses std::allocator,
+// so .JSON nodes are counted through these as well
+void* operator new(std::size_t size) { return countedAllocateOrThrow(size); }
+void* operator new[](std::size_t size) { return countedAllocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size == 0 ? 1 : size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size == 0 ? 1 : size); }
+void operator delete(void* pointer) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { countedFree(pointer); }
+
+// Check whether the converter was built with allocation accounting (TES3AB_ALLOCATION_STATS)
+bool allocationStatsEnabled() {
+    return true;
+}
+
+// Function to read the current allocation counters
+AllocationSnapshot allocationSnapshot() {
+    AllocationSnapshot snapshot;
+    snapshot.allocations = allocationCount.load(std::memory_order_relaxed);
+    snapshot.allocatedBytes = allocatedByteCount.load(std::memory_order_relaxed);
+    snapshot.liveBytes = liveByteCount.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+// Function to open a nested peak window; returns the outer peak that must be passed to endPeakWindow
+std::uint64_t beginPeakWindow() {
+    return peakLiveByteCount.exchange(liveByteCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// Function to close a peak window; returns the peak live bytes seen inside it
+std::uint64_t endPeakWindow(std::uint64_t outerPeak) {
+    std::uint64_t windowPeak = peakLiveByteCount.load(std::memory_order_relaxed);
+    updatePeak(outerPeak);
+    return windowPeak;
+}
+
+#else
+
+// Check whether the converter was built with allocation accounting (TES3AB_ALLOCATION_STATS)
+bool allocationStatsEnabled() {
+    return false;
+}
+
+// Function to read the current allocation counters
+AllocationSnapshot allocationSnapshot() {
+    return {};
+}
+
+// Function to open a nested peak window; returns the outer peak that must be passed to endPeakWindow
+std::uint64_t beginPeakWindow() {
+    return 0;
+}
+
+// Function to close a peak window; returns the peak live bytes seen inside it
+std::uint64_t endPeakWindow(std::uint64_t) {
+    return 0;
+}
+
+#endif
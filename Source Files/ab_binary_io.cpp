@@ -0,0 +1,38 @@
+#include <fstream>
+
+#include "ab_binary_io.h"
+
+// Function to hash a block of bytes (FNV-1a 64-bit); pass the previous result to continue a hash
+std::uint64_t hashBytes(std::string_view data, std::uint64_t hash) {
+    for (char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Function to read a whole file into memory
+bool readFileBytes(const std::filesystem::path& filePath, std::string& data) {
+    std::ifstream inputFile(filePath, std::ios::binary | std::ios::ate);
+    if (!inputFile) {
+        return false;
+    }
+
+    std::streamsize size = inputFile.tellg();
+    if (size < 0) {
+        return false;
+    }
+    data.resize(static_cast<size_t>(size));
+    inputFile.seekg(0);
+    return static_cast<bool>(inputFile.read(data.data(), size));
+}
+
+// Function to write a block of bytes to a file
+bool writeFileBytes(const std::filesystem::path& filePath, std::string_view data) {
+    std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+    if (!outputFile) {
+        return false;
+    }
+    outputFile.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(outputFile);
+}
@@ -0,0 +1,277 @@
+#include <format>
+#include <utility>
+
+#include "ab_binary_io.h"
+#include "ab_binary_patch.h"
+#include "ab_edit_plan.h"
+#include "ab_logger.h"
+
+// Define the binary patch file format constants
+static constexpr std::string_view PATCH_MAGIC = "TES3ABPT";
+static constexpr std::uint32_t PATCH_VERSION = 1;
+
+// Unchanged bytes shorter than this between two changed bytes are folded into one run
+static constexpr size_t PATCH_MERGE_GAP = 8;
+
+// Helper function to split the start of a byte range into whole TES3 records or subrecords (size field at bytes 4-8 of the header)
+static void splitChunks(std::string_view data, size_t headerSize, std::vector<std::string_view>& chunks) {
+    size_t pos = 0;
+    while (data.size() - pos >= headerSize) {
+        size_t size = readLittleEndian32(data.data() + pos + 4);
+        if (size > data.size() - pos - headerSize) {
+            break;
+        }
+        chunks.push_back(data.substr(pos, headerSize + size));
+        pos += headerSize + size;
+    }
+}
+
+// Helper function to add the runs between two ranges of the same size
+static void diffSameSize(std::string_view source, std::string_view target, std::uint64_t offset, BinaryPatch& patch) {
+    size_t i = 0;
+    while (i < source.size()) {
+        if (source[i] == target[i]) {
+            ++i;
+            continue;
+        }
+
+        size_t end = i + 1;
+        size_t equalBytes = 0;
+        for (size_t j = end; j < source.size() && equalBytes < PATCH_MERGE_GAP; ++j) {
+            if (source[j] == target[j]) {
+                ++equalBytes;
+            }
+            else {
+                equalBytes = 0;
+                end = j + 1;
+            }
+        }
+
+        patch.runs.push_back({ offset + i, std::string(source.substr(i, end - i)), std::string(target.substr(i, end - i)) });
+        i = end;
+    }
+}
+
+// Helper function to add a single run over the changed middle part of two ranges
+static void diffReplace(std::string_view source, std::string_view target, std::uint64_t offset, BinaryPatch& patch) {
+    size_t prefix = 0;
+    while (prefix < source.size() && prefix < target.size() && source[prefix] == target[prefix]) {
+        ++prefix;
+    }
+    size_t suffix = 0;
+    while (suffix < source.size() - prefix && suffix < target.size() - prefix &&
+           source[source.size() - 1 - suffix] == target[target.size() - 1 - suffix]) {
+        ++suffix;
+    }
+
+    patch.runs.push_back({ offset + prefix, std::string(source.substr(prefix, source.size() - prefix - suffix)),
+        std::string(target.substr(prefix, target.size() - prefix - suffix)) });
+}
+
+// Helper function to add the runs between two ranges; level 0 is a sequence of records, level 1 a sequence of subrecords
+static void diffRange(std::string_view source, std::string_view target, std::uint64_t offset, int level, BinaryPatch& patch) {
+    if (source == target) {
+        return;
+    }
+    if (source.size() == target.size()) {
+        diffSameSize(source, target, offset, patch);
+        return;
+    }
+
+    // Records or subrecords that grew or shrank: pair them up by position and name, diff each pair,
+    // then replace whatever is left after the first pair that does not match
+    if (level < 2) {
+        size_t headerSize = level == 0 ? RECORD_HEADER_SIZE : SUBRECORD_HEADER_SIZE;
+        std::vector<std::string_view> sourceChunks, targetChunks;
+        splitChunks(source, headerSize, sourceChunks);
+        splitChunks(target, headerSize, targetChunks);
+
+        size_t sourcePos = 0, targetPos = 0;
+        for (size_t i = 0; i < sourceChunks.size() && i < targetChunks.size(); ++i) {
+            std::string_view sourceChunk = sourceChunks[i];
+            std::string_view targetChunk = targetChunks[i];
+            if (sourceChunk.substr(0, 4) != targetChunk.substr(0, 4)) {
+                break;
+            }
+            if (sourceChunk != targetChunk) {
+                diffSameSize(sourceChunk.substr(0, headerSize), targetChunk.substr(0, headerSize), offset + sourcePos, patch);
+                diffRange(sourceChunk.substr(headerSize), targetChunk.substr(headerSize), offset + sourcePos + headerSize, level + 1, patch);
+            }
+            sourcePos += sourceChunk.size();
+            targetPos += targetChunk.size();
+        }
+
+        if (source.substr(sourcePos) != target.substr(targetPos)) {
+            diffReplace(source.substr(sourcePos), target.substr(targetPos), offset + sourcePos, patch);
+        }
+        return;
+    }
+
+    diffReplace(source, target, offset, patch);
+}
+
+// Function to build the patch turning one plugin file into another (diffed record by record and subrecord by subrecord)
+BinaryPatch buildBinaryPatch(std::string_view source, std::string_view target) {
+    BinaryPatch patch;
+    patch.sourceSize = source.size();
+    patch.sourceHash = hashBytes(source);
+    patch.targetSize = target.size();
+    patch.targetHash = hashBytes(target);
+    diffRange(source, target, 0, 0, patch);
+    return patch;
+}
+
+// Function to build the patch that undoes a patch (offsets moved to the target, bytes, sizes, hashes and direction swapped)
+BinaryPatch invertBinaryPatch(const BinaryPatch& patch) {
+    BinaryPatch inverse;
+    inverse.conversionType = patch.conversionType == 1 ? 2 : (patch.conversionType == 2 ? 1 : 0);
+    inverse.sourceSize = patch.targetSize;
+    inverse.sourceHash = patch.targetHash;
+    inverse.targetSize = patch.sourceSize;
+    inverse.targetHash = patch.sourceHash;
+    inverse.runs = patch.runs;
+
+    // Each run moves by the length change of the runs before it
+    std::int64_t shift = 0;
+    for (auto& run : inverse.runs) {
+        run.offset = static_cast<std::uint64_t>(static_cast<std::int64_t>(run.offset) + shift);
+        shift += static_cast<std::int64_t>(run.newBytes.size()) - static_cast<std::int64_t>(run.oldBytes.size());
+        std::swap(run.oldBytes, run.newBytes);
+    }
+
+    return inverse;
+}
+
+// Function to apply a patch; fails unless the source and every run match the patch and the result matches the target hash
+bool applyBinaryPatch(std::string_view source, const BinaryPatch& patch, std::string& target, std::string& error) {
+    if (source.size() != patch.sourceSize || hashBytes(source) != patch.sourceHash) {
+        error = "file does not match the patch source";
+        return false;
+    }
+
+    target.clear();
+    target.reserve(source.size());
+    size_t pos = 0;
+    for (size_t i = 0; i < patch.runs.size(); ++i) {
+        const PatchRun& run = patch.runs[i];
+        if (run.offset < pos || run.offset > source.size() || run.oldBytes.size() > source.size() - run.offset) {
+            error = std::format("run {} is out of range", i);
+            return false;
+        }
+        size_t offset = static_cast<size_t>(run.offset);
+        if (source.substr(offset, run.oldBytes.size()) != run.oldBytes) {
+            error = std::format("run {} does not match the file", i);
+            return false;
+        }
+
+        target.append(source.substr(pos, offset - pos));
+        target += run.newBytes;
+        pos = offset + run.oldBytes.size();
+    }
+    target.append(source.substr(pos));
+
+    if (target.size() != patch.targetSize || hashBytes(target) != patch.targetHash) {
+        error = "result does not match the patch target";
+        return false;
+    }
+    return true;
+}
+
+// Function to count the old and new bytes stored in the runs of a patch
+std::uint64_t binaryPatchPayload(const BinaryPatch& patch) {
+    std::uint64_t bytes = 0;
+    for (const auto& run : patch.runs) {
+        bytes += run.oldBytes.size() + run.newBytes.size();
+    }
+    return bytes;
+}
+
+// Function to convert a binary patch to its file format:
+// magic, version, conversion type, source size and hash, target size and hash, run count,
+// then per run its offset, old and new length followed by the old and new bytes (all values little-endian)
+std::string serializeBinaryPatch(const BinaryPatch& patch) {
+    std::string output(PATCH_MAGIC);
+    output.reserve(64 + patch.runs.size() * 16 + binaryPatchPayload(patch));
+    appendLittleEndian(output, PATCH_VERSION, 4);
+    appendLittleEndian(output, static_cast<std::uint32_t>(patch.conversionType), 4);
+    appendLittleEndian(output, patch.sourceSize, 8);
+    appendLittleEndian(output, patch.sourceHash, 8);
+    appendLittleEndian(output, patch.targetSize, 8);
+    appendLittleEndian(output, patch.targetHash, 8);
+    appendLittleEndian(output, patch.runs.size(), 4);
+
+    for (const auto& run : patch.runs) {
+        appendLittleEndian(output, run.offset, 8);
+        appendLittleEndian(output, run.oldBytes.size(), 4);
+        appendLittleEndian(output, run.newBytes.size(), 4);
+        output += run.oldBytes;
+        output += run.newBytes;
+    }
+    return output;
+}
+
+// Function to read a binary patch from its file format
+bool deserializeBinaryPatch(std::string_view data, BinaryPatch& patch, std::string& error) {
+    if (data.substr(0, PATCH_MAGIC.size()) != PATCH_MAGIC) {
+        error = "not a binary patch";
+        return false;
+    }
+
+    size_t pos = PATCH_MAGIC.size();
+    std::uint64_t version = 0, conversionType = 0, runCount = 0;
+    patch = BinaryPatch();
+    if (!readLittleEndian(data, pos, 4, version) || version != PATCH_VERSION) {
+        error = "unsupported binary patch version";
+        return false;
+    }
+    if (!readLittleEndian(data, pos, 4, conversionType) ||
+        !readLittleEndian(data, pos, 8, patch.sourceSize) || !readLittleEndian(data, pos, 8, patch.sourceHash) ||
+        !readLittleEndian(data, pos, 8, patch.targetSize) || !readLittleEndian(data, pos, 8, patch.targetHash) ||
+        !readLittleEndian(data, pos, 4, runCount)) {
+        error = "truncated binary patch header";
+        return false;
+    }
+    patch.conversionType = static_cast<int>(conversionType);
+
+    for (std::uint64_t i = 0; i < runCount; ++i) {
+        PatchRun run;
+        std::uint64_t oldLength = 0, newLength = 0;
+        if (!readLittleEndian(data, pos, 8, run.offset) || !readLittleEndian(data, pos, 4, oldLength) ||
+            !readLittleEndian(data, pos, 4, newLength) || data.size() - pos < oldLength + newLength) {
+            error = std::format("truncated binary patch run {}", i);
+            return false;
+        }
+        run.oldBytes = data.substr(pos, static_cast<size_t>(oldLength));
+        pos += static_cast<size_t>(oldLength);
+        run.newBytes = data.substr(pos, static_cast<size_t>(newLength));
+        pos += static_cast<size_t>(newLength);
+        patch.runs.push_back(std::move(run));
+    }
+
+    return true;
+}
+
+// Function to save a binary patch file
+bool saveBinaryPatch(const std::filesystem::path& patchPath, const BinaryPatch& patch, std::ofstream& logFile) {
+    if (!writeFileBytes(patchPath, serializeBinaryPatch(patch))) {
+        logMessage("ERROR - failed to save binary patch: " + patchPath.string(), logFile);
+        return false;
+    }
+    return true;
+}
+
+// Function to load a binary patch file
+bool loadBinaryPatch(const std::filesystem::path& patchPath, BinaryPatch& patch, std::ofstream& logFile) {
+    std::string data;
+    if (!readFileBytes(patchPath, data)) {
+        logMessage("ERROR - failed to open binary patch: " + patchPath.string(), logFile);
+        return false;
+    }
+
+    std::string error;
+    if (!deserializeBinaryPatch(data, patch, error)) {
+        logMessage("ERROR - failed to read binary patch " + patchPath.string() + ": " + error, logFile);
+        return false;
+    }
+    return true;
+}
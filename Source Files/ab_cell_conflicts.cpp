@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <tuple>
+
+#include "ab_cell_conflicts.h"
+#include "ab_logger.h"
+
+// Function to describe the record kinds of a touch mask ("CELL, LAND, PGRD")
+std::string formatCellTouchKinds(unsigned kinds) {
+    std::string result;
+    auto append = [&](unsigned kind, const char* name) {
+        if (kinds & kind) {
+            result += result.empty() ? name : std::string(", ") + name;
+        }
+        };
+    append(CELL_TOUCH_CELL, "CELL");
+    append(CELL_TOUCH_LANDSCAPE, "LAND");
+    append(CELL_TOUCH_PATHGRID, "PGRD");
+    return result;
+}
+
+// Get the shard holding a cell of a conversion direction
+size_t CellConflictMap::shardOf(int conversionType, int gridX, int gridY) {
+    return (PairHash{}({ gridX, gridY }) + static_cast<size_t>(conversionType)) % SHARD_COUNT;
+}
+
+// Add the cells one converted plugin touched; touches without a conversion type take conversionType
+void CellConflictMap::add(const std::string& pluginName, int conversionType, const std::vector<CellTouch>& touches) {
+    if (touches.empty()) {
+        return;
+    }
+
+    size_t pluginId = 0;
+    {
+        std::lock_guard<std::mutex> lock(pluginsMutex_);
+        pluginId = plugins_.size();
+        plugins_.push_back(pluginName);
+    }
+
+    // Group the touches by shard, so each shard is locked once
+    auto directionOf = [conversionType](const CellTouch& touch) { return touch.conversionType != 0 ? touch.conversionType : conversionType; };
+    std::vector<std::pair<size_t, const CellTouch*>> ordered;
+    ordered.reserve(touches.size());
+    for (const auto& touch : touches) {
+        ordered.emplace_back(shardOf(directionOf(touch), touch.gridX, touch.gridY), &touch);
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (size_t begin = 0; begin < ordered.size();) {
+        Shard& shard = shards_[ordered[begin].first];
+        size_t end = begin;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (; end < ordered.size() && ordered[end].first == ordered[begin].first; ++end) {
+            const CellTouch& touch = *ordered[end].second;
+            CellClaims& claims = shard.cells[directionOf(touch)][{ touch.gridX, touch.gridY }];
+            if (claims.plugins.empty()) {
+                claims.newGridX = touch.newGridX;
+                claims.newGridY = touch.newGridY;
+            }
+
+            // All touches of a cell by this plugin are handled under the same lock, so its claim is the last one
+            if (!claims.plugins.empty() && claims.plugins.back().first == pluginId) {
+                claims.plugins.back().second |= touch.kinds;
+            }
+            else {
+                claims.plugins.emplace_back(pluginId, touch.kinds);
+            }
+        }
+        begin = end;
+    }
+}
+
+// Get the cells touched by more than one plugin, sorted by direction and cell; plugins are listed in the order they
+// were added
+std::vector<CellConflict> CellConflictMap::conflicts() const {
+    std::vector<CellConflict> result;
+    std::vector<std::string> plugins;
+    {
+        std::lock_guard<std::mutex> lock(pluginsMutex_);
+        plugins = plugins_;
+    }
+
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [conversionType, cells] : shard.cells) {
+            for (const auto& [cell, claims] : cells) {
+                if (claims.plugins.size() < 2) {
+                    continue;
+                }
+
+                CellConflict conflict;
+                conflict.conversionType = conversionType;
+                conflict.gridX = cell.first;
+                conflict.gridY = cell.second;
+                conflict.newGridX = claims.newGridX;
+                conflict.newGridY = claims.newGridY;
+                std::vector<std::pair<size_t, unsigned>> claimed = claims.plugins;
+                std::sort(claimed.begin(), claimed.end());
+                for (const auto& [pluginId, kinds] : claimed) {
+                    conflict.plugins.emplace_back(pluginId < plugins.size() ? plugins[pluginId] : std::string(), kinds);
+                }
+                result.push_back(std::move(conflict));
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const CellConflict& a, const CellConflict& b) {
+        return std::make_tuple(a.conversionType, a.gridX, a.gridY) < std::make_tuple(b.conversionType, b.gridX, b.gridY);
+        });
+    return result;
+}
+
+// Function to log the cells edited by more than one plugin
+void logCellConflicts(const std::vector<CellConflict>& conflicts, std::ofstream& logFile) {
+    if (conflicts.empty()) {
+        return;
+    }
+
+    AB_LOG_WARN(LOG_GRID, logFile, "\nWARNING - {} grid cells are edited by more than one plugin:", conflicts.size());
+    for (const auto& conflict : conflicts) {
+        std::string line = std::string("- ") + (conflict.conversionType == 2 ? "AB->BM" : "BM->AB") + " (" + std::to_string(conflict.gridX) + ", " + std::to_string(conflict.gridY) + ") -> (" +
+            std::to_string(conflict.newGridX) + ", " + std::to_string(conflict.newGridY) + "):";
+        for (size_t i = 0; i < conflict.plugins.size(); ++i) {
+            line += (i == 0 ? " " : ", ") + conflict.plugins[i].first + " [" + formatCellTouchKinds(conflict.plugins[i].second) + "]";
+        }
+        AB_LOG_WARN(LOG_GRID, logFile, "{}", line);
+    }
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <set>
+
+#include "ab_binary_io.h"
+#include "ab_content_probe.h"
+#include "ab_coverage_index.h"
+
+// Helper function to read a little-endian 32-bit float
+static float readFloat32(const char* data) {
+    std::uint32_t bits = readLittleEndian32(data);
+    float value = 0.0f;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Helper function to check whether any mapping moves a grid cell
+static bool isMappedCell(const std::vector<const CellMapping*>& mappings, int gridX, int gridY) {
+    int destX = 0, destY = 0;
+    return std::any_of(mappings.begin(), mappings.end(), [&](const CellMapping* mapping) {
+        return mapping->find(gridX, gridY, destX, destY);
+        });
+}
+
+// Helper function to check whether a world position (door or travel destination) lies in a mapped cell
+static bool isMappedPosition(const std::vector<const CellMapping*>& mappings, const char* position) {
+    double worldX = readFloat32(position);
+    double worldY = readFloat32(position + 4);
+    if (!std::isfinite(worldX) || !std::isfinite(worldY)) {
+        return false;
+    }
+    return isMappedCell(mappings, static_cast<int>(std::floor(worldX / 8192.0)), static_cast<int>(std::floor(worldY / 8192.0)));
+}
+
+// Helper function to check whether a script or dialogue result could hold a coordinate command the handlers would change
+static bool isMappedScript(const std::vector<const CellMapping*>& mappings, std::string_view text) {
+    // Most texts have no coordinate command at all, so look for the command stems before running the parser
+    static const std::array<const char*, 5> stems = { "position", "aiescort", "aifollow", "aitravel", "placeitem" };
+    std::string lowered(text);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (std::none_of(stems.begin(), stems.end(), [&](const char* stem) { return lowered.find(stem) != std::string::npos; })) {
+        return false;
+    }
+
+    // Commands without literal coordinates cannot be ruled out here
+    std::set<std::pair<int, int>> cells;
+    if (collectScriptCells(std::string(text), cells) > 0) {
+        return true;
+    }
+    return std::any_of(cells.begin(), cells.end(), [&](const std::pair<int, int>& cell) {
+        return isMappedCell(mappings, cell.first, cell.second);
+        });
+}
+
+// Function to scan a raw TES3 plugin, without decoding it, for anything the handlers could change with one of the
+// mappings: exterior cells, landscapes and path grids in a mapped cell, door and travel destinations into one, and
+// script or dialogue coordinate commands with coordinates in one (or coordinates that are not literal numbers)
+ContentProbe probePluginContent(std::string_view data, const std::vector<const CellMapping*>& mappings) {
+    ContentProbe probe;
+    if (data.size() < RECORD_HEADER_SIZE || data.substr(0, 4) != "TES3") {
+        return probe;
+    }
+
+    size_t pos = 0;
+    while (pos < data.size()) {
+        if (data.size() - pos < RECORD_HEADER_SIZE) {
+            return probe;
+        }
+        const std::string_view tag = data.substr(pos, 4);
+        const size_t size = readLittleEndian32(data.data() + pos + 4);
+        const size_t begin = pos + RECORD_HEADER_SIZE;
+        if (data.size() - begin < size) {
+            return probe;
+        }
+        const size_t end = begin + size;
+        pos = end;
+
+        const bool isCell = tag == "CELL";
+        const bool isLandscape = tag == "LAND";
+        const bool isPathGrid = tag == "PGRD";
+        const bool isNpc = tag == "NPC_";
+        const bool isScript = tag == "SCPT";
+        const bool isInfo = tag == "INFO";
+        if (!isCell && !isLandscape && !isPathGrid && !isNpc && !isScript && !isInfo) {
+            continue;
+        }
+
+        bool cellHeaderRead = false;
+        for (size_t sub = begin; sub < end;) {
+            if (end - sub < SUBRECORD_HEADER_SIZE) {
+                return probe;
+            }
+            const std::string_view subTag = data.substr(sub, 4);
+            const size_t subSize = readLittleEndian32(data.data() + sub + 4);
+            const char* subData = data.data() + sub + SUBRECORD_HEADER_SIZE;
+            if (end - sub - SUBRECORD_HEADER_SIZE < subSize) {
+                return probe;
+            }
+            sub += SUBRECORD_HEADER_SIZE + subSize;
+
+            bool relevant = false;
+            if (isCell && subTag == "DATA" && !cellHeaderRead && subSize >= 12) {
+                // The grid handler moves every Cell record whose grid is mapped, interior or not
+                cellHeaderRead = true;
+                relevant = isMappedCell(mappings, static_cast<std::int32_t>(readLittleEndian32(subData + 4)),
+                    static_cast<std::int32_t>(readLittleEndian32(subData + 8)));
+            }
+            else if ((isCell || isNpc) && subTag == "DODT" && subSize >= 8) {
+                relevant = isMappedPosition(mappings, subData);
+            }
+            else if ((isLandscape && subTag == "INTV" && subSize >= 8) || (isPathGrid && subTag == "DATA" && subSize >= 8)) {
+                relevant = isMappedCell(mappings, static_cast<std::int32_t>(readLittleEndian32(subData)),
+                    static_cast<std::int32_t>(readLittleEndian32(subData + 4)));
+            }
+            else if ((isScript && subTag == "SCTX") || (isInfo && subTag == "BNAM")) {
+                relevant = isMappedScript(mappings, std::string_view(subData, subSize));
+            }
+
+            if (relevant) {
+                probe.result = ProbeResult::Relevant;
+                probe.match = std::string(tag) + " " + std::string(subTag) + " at offset " + std::to_string(begin - RECORD_HEADER_SIZE);
+                return probe;
+            }
+        }
+    }
+
+    probe.result = ProbeResult::NothingToConvert;
+    return probe;
+}
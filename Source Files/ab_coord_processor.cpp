@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <charconv>
+#include <format>
 #include <iostream>
 #include <unordered_set>
 #include <sstream>
@@ -5,6 +8,7 @@
 
 #include <sqlite3.h>
 
+#include "ab_binary_io.h"
 #include "ab_coord_processor.h"
 #include "ab_logger.h"
 
@@ -21,96 +25,321 @@ GridOffset getGridOffset(int conversionType) {
     else return { -7, -6 };
 }
 
-// Function to load custom grid coordinates
-void loadCustomGridCoordinates(const std::string& filePath,
+// Define the compiled custom coordinates cache format constants
+static constexpr std::string_view CUSTOM_CACHE_MAGIC = "TES3ABCC";
+static constexpr std::uint32_t CUSTOM_CACHE_VERSION = 2;
+static constexpr size_t CUSTOM_CACHE_HEADER_SIZE = 8 + 4 + 8 + 8 + 4;
+
+// A single range or rectangle may not expand to more cells than this (the world is a few hundred cells across)
+static constexpr std::int64_t MAX_CUSTOM_RANGE_CELLS = std::int64_t{ 1 } << 22;
+
+// Helper function to trim spaces and tabs from both ends of a view
+static std::string_view trimView(std::string_view text) {
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+// Helper function to parse a whole view as one integer; a leading '+' is accepted like stream input does
+static bool parseInteger(std::string_view text, int& value) {
+    text = trimView(text);
+    if (text.size() > 1 && text.front() == '+' && text[1] != '-' && text[1] != '+') {
+        text.remove_prefix(1);
+    }
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size() && !text.empty();
+}
+
+// Helper function to parse a single grid coordinate "N" or an inclusive range "N..M" (either order)
+static bool parseCoordinateRange(std::string_view text, int& first, int& last) {
+    size_t dots = text.find("..");
+    if (dots == std::string_view::npos) {
+        if (!parseInteger(text, first)) return false;
+        last = first;
+        return true;
+    }
+    if (!parseInteger(text.substr(0, dots), first) || !parseInteger(text.substr(dots + 2), last)) {
+        return false;
+    }
+    if (first > last) std::swap(first, last);
+    return true;
+}
+
+// Function to get the compiled cache file of a custom grid coordinates file (same name, .cache extension)
+std::filesystem::path customCoordinatesCachePath(const std::string& filePath) {
+    return std::filesystem::path(filePath).replace_extension(".cache");
+}
+
+// Function to parse the text of a custom grid coordinates file: one "X,Y" cell, "x1..x2,Y" / "X,y1..y2" range or
+// "x1..x2,y1..y2" rectangle per line, "//" starts a comment (a whole line or the rest of one)
+void parseCustomGridCoordinates(std::string_view text,
     std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates,
     std::ofstream& logFile) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+    size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) lineEnd = text.size();
+        std::string_view line = text.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
+        // Drop comments and skip the lines left empty
+        line = trimView(line.substr(0, line.find("//")));
+        if (line.empty()) {
+            continue;
+        }
+
+        size_t comma = line.find(',');
+        int minX = 0, maxX = 0, minY = 0, maxY = 0;
+        if (comma == std::string_view::npos || line.find(',', comma + 1) != std::string_view::npos ||
+            !parseCoordinateRange(line.substr(0, comma), minX, maxX) || !parseCoordinateRange(line.substr(comma + 1), minY, maxY)) {
+            logMessage("WARNING - invalid coordinate format: " + std::string(line), logFile);
+            continue;
+        }
+
+        std::int64_t cells = (static_cast<std::int64_t>(maxX) - minX + 1) * (static_cast<std::int64_t>(maxY) - minY + 1);
+        if (cells > MAX_CUSTOM_RANGE_CELLS) {
+            logMessage(std::format("WARNING - coordinate range too large ({} cells): {}", cells, line), logFile);
+            continue;
+        }
+
+        AB_LOG_DEBUG(LOG_GRID, logFile, "- Coordinates: {}", line);
+        customCoordinates.reserve(customCoordinates.size() + static_cast<size_t>(cells));
+        for (std::int64_t x = minX; x <= maxX; ++x) {
+            for (std::int64_t y = minY; y <= maxY; ++y) {
+                customCoordinates.emplace(static_cast<int>(x), static_cast<int>(y));
+            }
+        }
+    }
+}
+
+// Function to convert expanded custom grid coordinates to the cache format: magic, version, hash and size of the text
+// file, cell count, then X and Y per cell sorted by X and Y (all values little-endian)
+std::string serializeCustomCoordinatesCache(const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates,
+    std::uint64_t textHash, std::uint64_t textSize) {
+    std::vector<std::pair<int, int>> cells(customCoordinates.begin(), customCoordinates.end());
+    std::sort(cells.begin(), cells.end());
+
+    std::string output(CUSTOM_CACHE_MAGIC);
+    output.reserve(CUSTOM_CACHE_HEADER_SIZE + cells.size() * 8);
+    appendLittleEndian(output, CUSTOM_CACHE_VERSION, 4);
+    appendLittleEndian(output, textHash, 8);
+    appendLittleEndian(output, textSize, 8);
+    appendLittleEndian(output, cells.size(), 4);
+    for (const auto& [gridX, gridY] : cells) {
+        appendLittleEndian(output, static_cast<std::uint32_t>(gridX), 4);
+        appendLittleEndian(output, static_cast<std::uint32_t>(gridY), 4);
+    }
+    return output;
+}
+
+// Function to read expanded custom grid coordinates from the cache format; fails unless the cache was compiled from
+// a text file with the given hash and size
+bool deserializeCustomCoordinatesCache(std::string_view data, std::uint64_t textHash, std::uint64_t textSize,
+    std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates) {
+    if (data.size() < CUSTOM_CACHE_HEADER_SIZE || data.substr(0, CUSTOM_CACHE_MAGIC.size()) != CUSTOM_CACHE_MAGIC) {
+        return false;
+    }
+
+    size_t pos = CUSTOM_CACHE_MAGIC.size();
+    std::uint64_t version = 0, hash = 0, size = 0, count = 0;
+    if (!readLittleEndian(data, pos, 4, version) || !readLittleEndian(data, pos, 8, hash) || !readLittleEndian(data, pos, 8, size) ||
+        !readLittleEndian(data, pos, 4, count)) {
+        return false;
+    }
+    if (version != CUSTOM_CACHE_VERSION || hash != textHash || size != textSize || data.size() - pos != count * 8) {
+        return false;
+    }
+
+    customCoordinates.reserve(customCoordinates.size() + static_cast<size_t>(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t gridX = 0, gridY = 0;
+        if (!readLittleEndian(data, pos, 4, gridX) || !readLittleEndian(data, pos, 4, gridY)) {
+            return false;
+        }
+        customCoordinates.emplace(static_cast<std::int32_t>(static_cast<std::uint32_t>(gridX)),
+            static_cast<std::int32_t>(static_cast<std::uint32_t>(gridY)));
+    }
+    return true;
+}
+
+// Function to load custom grid coordinates: the compiled cache next to the file is used while it matches the hash of
+// the text, otherwise the text is parsed (and the cache rewritten if updateCache is set)
+void loadCustomGridCoordinates(const std::string& filePath,
+    std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates,
+    bool updateCache, std::ofstream& logFile) {
+    std::string text;
+    if (!readFileBytes(filePath, text)) {
         logMessage("ERROR - failed to open custom grid coordinates file: " + filePath, logFile);
         return;
     }
 
-    bool hasAnyParsableLines = false;
+    const std::uint64_t textHash = hashBytes(text);
+    const std::filesystem::path cachePath = customCoordinatesCachePath(filePath);
+
+    // One read of the compiled cache
+    std::string cache;
+    std::unordered_set<std::pair<int, int>, PairHash> loaded;
+    if (readFileBytes(cachePath, cache) && deserializeCustomCoordinatesCache(cache, textHash, text.size(), loaded)) {
+        AB_LOG_INFO(LOG_GENERAL, logFile, "Loaded {} custom grid coordinates from cache: {}", loaded.size(), cachePath.string());
+        customCoordinates.insert(loaded.begin(), loaded.end());
+        return;
+    }
+
+    parseCustomGridCoordinates(text, loaded, logFile);
+    if (updateCache && !writeFileBytes(cachePath, serializeCustomCoordinatesCache(loaded, textHash, text.size()))) {
+        AB_LOG_DEBUG(LOG_GENERAL, logFile, "Failed to write custom grid coordinates cache: {}", cachePath.string());
+    }
+    AB_LOG_INFO(LOG_GENERAL, logFile, "Loaded {} custom grid coordinates from: {}", loaded.size(), filePath);
+    customCoordinates.insert(loaded.begin(), loaded.end());
+}
+
+// Constructor that builds the lookup (the first entry of a duplicated source cell wins)
+CellMapping::CellMapping(std::vector<CellMappingEntry> entries) : entries_(std::move(entries)) {
+    if (entries_.empty()) {
+        return;
+    }
+
+    std::int64_t maxX = entries_.front().sourceX, maxY = entries_.front().sourceY;
+    minX_ = maxX;
+    minY_ = maxY;
+    for (const auto& entry : entries_) {
+        minX_ = std::min<std::int64_t>(minX_, entry.sourceX);
+        minY_ = std::min<std::int64_t>(minY_, entry.sourceY);
+        maxX = std::max<std::int64_t>(maxX, entry.sourceX);
+        maxY = std::max<std::int64_t>(maxY, entry.sourceY);
+    }
+
+    // The world is a few hundred cells across; 4M slots (16 MB) is far beyond any real mapping
+    const std::int64_t maxDenseCells = std::int64_t{ 1 } << 22;
+    std::int64_t width = maxX - minX_ + 1;
+    std::int64_t height = maxY - minY_ + 1;
+
+    if (width * height <= maxDenseCells) {
+        width_ = width;
+        height_ = height;
+        slots_.assign(static_cast<size_t>(width_ * height_), -1);
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            std::int32_t& slot = slots_[static_cast<size_t>((entries_[i].sourceY - minY_) * width_ + (entries_[i].sourceX - minX_))];
+            if (slot < 0) slot = static_cast<std::int32_t>(i);
+        }
+    }
+    else {
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            sparse_.emplace(std::make_pair(entries_[i].sourceX, entries_[i].sourceY), static_cast<std::int32_t>(i));
+        }
+    }
+}
+
+// Mapping in the opposite direction (for non-injective mappings the first source of a destination wins)
+CellMapping CellMapping::inverted() const {
+    std::vector<CellMappingEntry> inverse;
+    inverse.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+        inverse.push_back({ entry.destX, entry.destY, entry.sourceX, entry.sourceY });
+    }
+    return CellMapping(std::move(inverse));
+}
+
+// Function to build the built-in Anthology Bloodmoon profile: database and custom cells shifted by getGridOffset
+CellMapping buildAnthologyMapping(const Database& db,
+    const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates,
+    int conversionType,
+    std::ofstream& logFile) {
+    GridOffset offset = getGridOffset(conversionType);
+    std::vector<CellMappingEntry> entries;
+
+    // The database lists Bloodmoon cells; for AB -> BM the source cells are the shifted ones
+    sqlite3_stmt* stmt = nullptr;
+    std::string query = "SELECT BM_Grid_X, BM_Grid_Y FROM [tes3_ab_cell_x-y_data]";
+
+    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        logMessage("ERROR - preparing database query: " + std::string(sqlite3_errmsg(db)), logFile);
+        if (stmt) sqlite3_finalize(stmt);
+    }
+    else {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            int gridX = sqlite3_column_int(stmt, 0);
+            int gridY = sqlite3_column_int(stmt, 1);
+            if (conversionType == 2) {
+                gridX -= offset.offsetX;
+                gridY -= offset.offsetY;
+            }
+            entries.push_back({ gridX, gridY, gridX + offset.offsetX, gridY + offset.offsetY });
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    // Custom cells are source cells in both directions; they are added sorted, so the mapping (and the fingerprint of
+    // incremental caches) does not depend on whether the set was parsed from the text or read from the compiled cache
+    std::vector<std::pair<int, int>> customCells(customCoordinates.begin(), customCoordinates.end());
+    std::sort(customCells.begin(), customCells.end());
+    for (const auto& [gridX, gridY] : customCells) {
+        entries.push_back({ gridX, gridY, gridX + offset.offsetX, gridY + offset.offsetY });
+    }
+
+    return CellMapping(std::move(entries));
+}
+
+// Function to load a mapping table (source X, source Y, destination X, destination Y per line) from a text file
+bool loadCellMappingFile(const std::string& filePath, std::vector<CellMappingEntry>& entries, std::ofstream& logFile) {
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        logMessage("ERROR - failed to open cell mapping file: " + filePath, logFile);
+        return false;
+    }
 
     std::string line;
     while (std::getline(file, line)) {
-        // Trim leading and trailing whitespace
+        // Drop comments (a whole line or the rest of one), then trim leading and trailing whitespace
+        line.erase(std::min(line.find("//"), line.size()));
         line.erase(0, line.find_first_not_of(" \t\r\n"));
         line.erase(line.find_last_not_of(" \t\r\n") + 1);
 
-        // Skip empty lines and comments
-        if (line.empty() || line.find("//") == 0) {
+        // Skip the lines left empty
+        if (line.empty()) {
             continue;
         }
 
-        // Search for first parsable line, log the header
-        if (!hasAnyParsableLines) {
-            logMessage("Loading custom grid coordinates:", logFile);
-            hasAnyParsableLines = true;
+        // Accept "X,Y,X,Y" as well as "X,Y -> X,Y"
+        std::replace(line.begin(), line.end(), ',', ' ');
+        size_t arrow = line.find("->");
+        if (arrow != std::string::npos) {
+            line[arrow] = line[arrow + 1] = ' ';
         }
 
         std::istringstream lineStream(line);
-        int x, y;
-        char comma;
+        CellMappingEntry entry{};
+        std::string rest;
 
-        if (lineStream >> x >> comma >> y && comma == ',') {
-            customCoordinates.emplace(x, y);
-            logMessage("- Coordinate: " + std::to_string(x) + "," + std::to_string(y), logFile);
+        if (lineStream >> entry.sourceX >> entry.sourceY >> entry.destX >> entry.destY && !(lineStream >> rest)) {
+            entries.push_back(entry);
         }
         else {
-            logMessage("WARNING - invalid coordinate format: " + line, logFile);
+            logMessage("WARNING - invalid cell mapping format: " + line, logFile);
         }
     }
 
-    file.close();
+    return true;
 }
 
-// Function to check if a given grid coordinate (gridX, gridY) is valid. It checks both the database and custom user-defined coordinates
-bool isCoordinateValid(const Database& db,
-    int gridX,
-    int gridY,
-    const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates,
-    const ProgramOptions& options,
-    std::ofstream& logFile) {
-    // Get the offset from the getGridOffset function
-    GridOffset offset = getGridOffset(options.conversionType);
-
-    int adjustedGridX = gridX;
-    int adjustedGridY = gridY;
-
-    // Apply the offset to the coordinates only for conversionType = 2
-    if (options.conversionType == 2) {
-        adjustedGridX = gridX + offset.offsetX;
-        adjustedGridY = gridY + offset.offsetY;
-    }
-
-    // Check in the database
-    sqlite3_stmt* stmt;
-    std::string query = "SELECT BM_Grid_X, BM_Grid_Y FROM [tes3_ab_cell_x-y_data] WHERE BM_Grid_X = ? AND BM_Grid_Y = ?";
+// Function to load a mapping table from the [tes3_ab_cell_mapping] table of a database
+bool loadCellMappingTable(const Database& db, std::vector<CellMappingEntry>& entries, std::ofstream& logFile) {
+    sqlite3_stmt* stmt = nullptr;
+    std::string query = "SELECT Source_Grid_X, Source_Grid_Y, Dest_Grid_X, Dest_Grid_Y FROM [tes3_ab_cell_mapping]";
 
     if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Error preparing database query: " + std::string(sqlite3_errmsg(db)) << "\n";
+        logMessage("ERROR - failed to read cell mapping table: " + std::string(sqlite3_errmsg(db)), logFile);
         if (stmt) sqlite3_finalize(stmt);
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, adjustedGridX);
-    sqlite3_bind_int(stmt, 2, adjustedGridY);
-
-    bool foundInDB = (sqlite3_step(stmt) == SQLITE_ROW);
-    sqlite3_finalize(stmt);
-
-    // If found in the database, return true
-    if (foundInDB) {
-        return true;
-    }
-
-    // Check in custom coordinates
-    if (customCoordinates.find({ gridX, gridY }) != customCoordinates.end()) {
-        return true;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        entries.push_back({ sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1),
+            sqlite3_column_int(stmt, 2), sqlite3_column_int(stmt, 3) });
     }
+    sqlite3_finalize(stmt);
 
-    // Not found in either
-    return false;
-}
\ No newline at end of file
+    return true;
+}
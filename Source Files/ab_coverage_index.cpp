@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#include "ab_coverage_index.h"
+#include "ab_file_processor.h"
+#include "ab_library.h"
+#include "ab_logger.h"
+
+// Coverage kinds as stored in the index
+static constexpr std::array<const char*, 4> COVERAGE_KINDS = { "cell", "land", "pgrd", "script" };
+
+// Function to add the cells of the coordinate commands in a script or dialogue result; the X argument position per
+// command matches the script handlers (the Y coordinate follows it). Returns the number of commands without literal coordinates
+size_t collectScriptCells(const std::string& text, std::set<std::pair<int, int>>& cells) {
+    static const std::regex commandRegex(
+        R"(\b(AiEscortCell|AiEscort|AiFollowCell|AiFollow|AiTravel|PositionCell|Position|PlaceItemCell|PlaceItem)\b([^\r\n;]*))",
+        std::regex_constants::icase);
+    static const std::regex argumentRegex(R"("[^"]*"|[^\s,]+)");
+    static const std::map<std::string, size_t> xArgument = {
+        { "aitravel", 0 }, { "position", 0 }, { "positioncell", 0 }, { "placeitem", 1 }, { "placeitemcell", 2 },
+        { "aiescort", 2 }, { "aifollow", 2 }, { "aiescortcell", 3 }, { "aifollowcell", 3 } };
+
+    size_t unread = 0;
+    for (auto command = std::sregex_iterator(text.begin(), text.end(), commandRegex); command != std::sregex_iterator(); ++command) {
+        std::string name = (*command)[1].str();
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        std::vector<std::string> arguments;
+        const std::string rest = (*command)[2].str();
+        for (auto argument = std::sregex_iterator(rest.begin(), rest.end(), argumentRegex); argument != std::sregex_iterator(); ++argument) {
+            arguments.push_back(argument->str());
+        }
+
+        size_t x = xArgument.at(name);
+        if (arguments.size() < x + 2) {
+            ++unread;
+            continue;
+        }
+        try {
+            double worldX = std::stod(arguments[x]);
+            double worldY = std::stod(arguments[x + 1]);
+            cells.emplace(static_cast<int>(std::floor(worldX / 8192.0)), static_cast<int>(std::floor(worldY / 8192.0)));
+        }
+        catch (const std::exception&) {
+            // Not a literal coordinate (variable or malformed command)
+            ++unread;
+        }
+    }
+    return unread;
+}
+
+// Function to collect the exterior cells, LAND and PGRD grids and script/dialogue coordinate cells of a decoded plugin;
+// status tells whether the converter would process it ("convertible", "already converted" or "missing Parent Masters")
+PluginCoverage collectPluginCoverage(const ordered_json& plugin) {
+    PluginCoverage coverage;
+    if (!plugin.is_array()) {
+        coverage.status = "invalid .JSON";
+        return coverage;
+    }
+
+    std::ofstream quietLog;
+    if (hasConversionTag(plugin, {}, quietLog)) {
+        coverage.status = "already converted";
+    }
+    else if (!checkDependencyOrder(plugin, quietLog).first) {
+        coverage.status = "missing Parent Masters";
+    }
+    else {
+        coverage.status = "convertible";
+    }
+
+    for (const auto& record : plugin) {
+        if (!record.is_object() || !record.contains("type") || !record["type"].is_string()) {
+            continue;
+        }
+        const std::string& type = record["type"].get_ref<const std::string&>();
+
+        if (type == "Cell" || type == "Landscape" || type == "PathGrid") {
+            std::pair<int, int> cell;
+            if (!readRecordGrid(record, cell.first, cell.second)) {
+                continue;
+            }
+
+            if (type == "Cell") {
+                bool interior = record.contains("data") && record["data"].contains("flags") && record["data"]["flags"].is_string() &&
+                    record["data"]["flags"].get_ref<const std::string&>().find("IS_INTERIOR") != std::string::npos;
+                if (!interior) {
+                    coverage.cells.insert(cell);
+                }
+            }
+            else if (type == "Landscape") {
+                coverage.landscapes.insert(cell);
+            }
+            else {
+                coverage.pathGrids.insert(cell);
+            }
+        }
+        else if (type == "Script" && record.contains("text") && record["text"].is_string()) {
+            collectScriptCells(record["text"].get_ref<const std::string&>(), coverage.scriptCells);
+        }
+        else if (type == "DialogueInfo" && record.contains("script_text") && record["script_text"].is_string()) {
+            collectScriptCells(record["script_text"].get_ref<const std::string&>(), coverage.scriptCells);
+        }
+    }
+
+    return coverage;
+}
+
+// Constructor that opens or creates the index (throws std::runtime_error)
+CoverageIndex::CoverageIndex(const std::string& indexPath)
+    : db_(indexPath) {
+    bool created = executeSql(db_, "PRAGMA journal_mode=WAL;") &&
+        executeSql(db_, "CREATE TABLE IF NOT EXISTS plugins ("
+                "path TEXT PRIMARY KEY, size INTEGER NOT NULL, modified INTEGER NOT NULL, content_hash TEXT NOT NULL);") &&
+        executeSql(db_, "CREATE INDEX IF NOT EXISTS plugins_by_hash ON plugins(content_hash);") &&
+        executeSql(db_, "CREATE TABLE IF NOT EXISTS contents (content_hash TEXT PRIMARY KEY, status TEXT NOT NULL);") &&
+        executeSql(db_, "CREATE TABLE IF NOT EXISTS coverage ("
+                "content_hash TEXT NOT NULL, kind TEXT NOT NULL, grid_x INTEGER NOT NULL, grid_y INTEGER NOT NULL, "
+                "PRIMARY KEY (content_hash, kind, grid_x, grid_y)) WITHOUT ROWID;") &&
+        executeSql(db_, "CREATE INDEX IF NOT EXISTS coverage_by_cell ON coverage(grid_x, grid_y);");
+    if (!created) {
+        throw std::runtime_error("Failed to set up coverage index: " + std::string(sqlite3_errmsg(db_)));
+    }
+}
+
+// Check whether a plugin is indexed with the given size and modification time
+bool CoverageIndex::isCurrent(const std::filesystem::path& pluginPath, std::uint64_t size, std::int64_t modified) const {
+    Statement stmt(db_, "SELECT 1 FROM plugins WHERE path = ?1 AND size = ?2 AND modified = ?3;");
+    stmt.bind(1, pluginPath.string());
+    stmt.bind(2, static_cast<std::int64_t>(size));
+    stmt.bind(3, modified);
+    return stmt.step() == SQLITE_ROW;
+}
+
+// Point a plugin at content that is already indexed; returns false if the content hash is unknown
+bool CoverageIndex::linkKnownContent(const std::filesystem::path& pluginPath, std::uint64_t size, std::int64_t modified, const std::string& contentHash) {
+    Statement known(db_, "SELECT 1 FROM contents WHERE content_hash = ?1;");
+    known.bind(1, contentHash);
+    if (known.step() != SQLITE_ROW) {
+        return false;
+    }
+
+    Statement stmt(db_, "INSERT OR REPLACE INTO plugins (path, size, modified, content_hash) VALUES (?1, ?2, ?3, ?4);");
+    stmt.bind(1, pluginPath.string());
+    stmt.bind(2, static_cast<std::int64_t>(size));
+    stmt.bind(3, modified);
+    stmt.bind(4, contentHash);
+    return stmt.step() == SQLITE_DONE;
+}
+
+// Store the coverage of new content and point the plugin at it
+bool CoverageIndex::store(const std::filesystem::path& pluginPath, std::uint64_t size, std::int64_t modified, const std::string& contentHash,
+    const PluginCoverage& coverage) {
+    if (!executeSql(db_, "BEGIN;")) {
+        return false;
+    }
+
+    bool stored = true;
+    {
+        Statement content(db_, "INSERT OR REPLACE INTO contents (content_hash, status) VALUES (?1, ?2);");
+        content.bind(1, contentHash);
+        content.bind(2, coverage.status);
+        stored = content.step() == SQLITE_DONE;
+
+        Statement cell(db_, "INSERT OR IGNORE INTO coverage (content_hash, kind, grid_x, grid_y) VALUES (?1, ?2, ?3, ?4);");
+        const std::array<const std::set<std::pair<int, int>>*, 4> kinds = {
+            &coverage.cells, &coverage.landscapes, &coverage.pathGrids, &coverage.scriptCells };
+        for (size_t k = 0; stored && k < kinds.size(); ++k) {
+            for (const auto& [gridX, gridY] : *kinds[k]) {
+                cell.bind(1, contentHash);
+                cell.bind(2, COVERAGE_KINDS[k]);
+                cell.bind(3, gridX);
+                cell.bind(4, gridY);
+                stored = cell.step() == SQLITE_DONE;
+                cell.reset();
+                if (!stored) {
+                    break;
+                }
+            }
+        }
+
+        Statement plugin(db_, "INSERT OR REPLACE INTO plugins (path, size, modified, content_hash) VALUES (?1, ?2, ?3, ?4);");
+        plugin.bind(1, pluginPath.string());
+        plugin.bind(2, static_cast<std::int64_t>(size));
+        plugin.bind(3, modified);
+        plugin.bind(4, contentHash);
+        stored = stored && plugin.step() == SQLITE_DONE;
+    }
+
+    return executeSql(db_, stored ? "COMMIT;" : "ROLLBACK;") && stored;
+}
+
+// Remove plugins whose files no longer exist and coverage no plugin points at; returns the removed plugin count
+size_t CoverageIndex::prune() {
+    std::vector<std::string> missing;
+    {
+        Statement stmt(db_, "SELECT path FROM plugins;");
+        while (stmt.step() == SQLITE_ROW) {
+            std::string path = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
+            std::error_code error;
+            if (!std::filesystem::exists(path, error)) {
+                missing.push_back(std::move(path));
+            }
+        }
+    }
+
+    executeSql(db_, "BEGIN;");
+    {
+        Statement remove(db_, "DELETE FROM plugins WHERE path = ?1;");
+        for (const auto& path : missing) {
+            remove.bind(1, path);
+            remove.step();
+            remove.reset();
+        }
+    }
+    executeSql(db_, "DELETE FROM coverage WHERE content_hash NOT IN (SELECT content_hash FROM plugins);");
+    executeSql(db_, "DELETE FROM contents WHERE content_hash NOT IN (SELECT content_hash FROM plugins);");
+    executeSql(db_, "COMMIT;");
+    return missing.size();
+}
+
+// Find the plugins touching any of the cells; mappedCells counts the touched cells the mapping would move
+std::vector<CoverageMatch> CoverageIndex::query(const std::vector<std::pair<int, int>>& cells, const CellMapping& mapping) const {
+    executeSql(db_, "CREATE TEMP TABLE IF NOT EXISTS query_cells (grid_x INTEGER NOT NULL, grid_y INTEGER NOT NULL, mapped INTEGER NOT NULL, "
+            "PRIMARY KEY (grid_x, grid_y)) WITHOUT ROWID;");
+    executeSql(db_, "DELETE FROM query_cells;");
+    executeSql(db_, "BEGIN;");
+    {
+        Statement insert(db_, "INSERT OR IGNORE INTO query_cells (grid_x, grid_y, mapped) VALUES (?1, ?2, ?3);");
+        for (const auto& [gridX, gridY] : cells) {
+            int destX = 0, destY = 0;
+            insert.bind(1, gridX);
+            insert.bind(2, gridY);
+            insert.bind(3, mapping.find(gridX, gridY, destX, destY) ? 1 : 0);
+            insert.step();
+            insert.reset();
+        }
+    }
+    executeSql(db_, "COMMIT;");
+
+    Statement stmt(db_,
+        "SELECT p.path, n.status, c.kind, COUNT(*) "
+        "FROM query_cells q "
+        "JOIN coverage c ON c.grid_x = q.grid_x AND c.grid_y = q.grid_y "
+        "JOIN plugins p ON p.content_hash = c.content_hash "
+        "JOIN contents n ON n.content_hash = c.content_hash "
+        "GROUP BY p.path, c.kind ORDER BY p.path;");
+
+    std::vector<CoverageMatch> matches;
+    while (stmt.step() == SQLITE_ROW) {
+        std::string path = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
+        if (matches.empty() || matches.back().path != path) {
+            CoverageMatch match;
+            match.path = std::move(path);
+            match.status = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+            matches.push_back(std::move(match));
+        }
+
+        CoverageMatch& match = matches.back();
+        std::string kind = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
+        size_t count = static_cast<size_t>(sqlite3_column_int64(stmt.get(), 3));
+        if (kind == "cell") match.cells = count;
+        else if (kind == "land") match.landscapes = count;
+        else if (kind == "pgrd") match.pathGrids = count;
+        else match.scriptCells = count;
+    }
+
+    // Mapped cells are counted once per plugin, however many record kinds touch them
+    Statement mapped(db_,
+        "SELECT path, COUNT(*) FROM ("
+        "SELECT DISTINCT p.path AS path, q.grid_x, q.grid_y "
+        "FROM query_cells q "
+        "JOIN coverage c ON c.grid_x = q.grid_x AND c.grid_y = q.grid_y "
+        "JOIN plugins p ON p.content_hash = c.content_hash "
+        "WHERE q.mapped = 1) "
+        "GROUP BY path ORDER BY path;");
+    auto match = matches.begin();
+    while (mapped.step() == SQLITE_ROW) {
+        const std::string path = reinterpret_cast<const char*>(sqlite3_column_text(mapped.get(), 0));
+        while (match != matches.end() && match->path < path) {
+            ++match;
+        }
+        if (match != matches.end() && match->path == path) {
+            match->mappedCells = static_cast<size_t>(sqlite3_column_int64(mapped.get(), 1));
+        }
+    }
+    return matches;
+}
+
+// Number of indexed plugins
+size_t CoverageIndex::pluginCount() const {
+    Statement stmt(db_, "SELECT COUNT(*) FROM plugins;");
+    return stmt.step() == SQLITE_ROW ? static_cast<size_t>(sqlite3_column_int64(stmt.get(), 0)) : 0;
+}
+
+// Function to parse a coverage query: "region" (every cell the mapping moves) or "X,Y;X,Y;..." cells
+bool parseCoverageQuery(const std::string& spec, const CellMapping& mapping, std::vector<std::pair<int, int>>& cells, std::ofstream& logFile) {
+    cells.clear();
+    if (spec == "region") {
+        for (const auto& entry : mapping.entries()) {
+            cells.emplace_back(entry.sourceX, entry.sourceY);
+        }
+        return true;
+    }
+
+    std::istringstream stream(spec);
+    std::string item;
+    while (std::getline(stream, item, ';')) {
+        int gridX = 0, gridY = 0;
+        char separator = 0;
+        std::istringstream cellStream(item);
+        if (!(cellStream >> gridX >> separator >> gridY) || separator != ',') {
+            logMessage("ERROR - invalid cell in coverage query: '" + item + "' (expected X,Y)", logFile);
+            return false;
+        }
+        cells.emplace_back(gridX, gridY);
+    }
+    return !cells.empty();
+}
@@ -1,13 +1,39 @@
+#include <charconv>
 #include <cmath>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 
 #include "ab_data_processor.h"
+#include "ab_event_log.h"
 #include "ab_logger.h"
 
+// Largest world coordinate whose grid cell still fits an int
+static constexpr double MAX_WORLD_COORDINATE = 8192.0 * 2147483647.0;
+
+// Helper function to read consecutive numeric arguments of a matched script command. Literals that do not fit a
+// double or a grid cell (e.g. hundreds of digits) are reported and the command is left unchanged
+static bool readCommandCoordinates(const std::smatch& match, size_t firstGroup, std::initializer_list<double*> values,
+    unsigned category, std::ofstream& logFile) {
+    size_t group = firstGroup;
+    for (double* value : values) {
+        const auto& argument = match[group++];
+        if (!argument.matched) {
+            return false;
+        }
+        const char* begin = &*argument.first;
+        const char* end = begin + argument.length();
+        auto [parsedEnd, error] = std::from_chars(begin, end, *value);
+        if (error != std::errc() || parsedEnd != end || !(std::fabs(*value) < MAX_WORLD_COORDINATE)) {
+            AB_LOG_WARN(category, logFile, "WARNING - coordinate out of range, command left unchanged: {}", match.str());
+            return false;
+        }
+    }
+    return true;
+}
+
 // Function to process translations for interior door coordinates
-void processInteriorDoorsTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processInteriorDoorsTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Loop through all objects in inputData
     for (auto& cell : inputData) {
@@ -28,15 +54,12 @@ void processInteriorDoorsTranslation(const Database& db, ordered_json& inputData
                             int gridX = static_cast<int>(std::floor(destX / 8192.0));
                             int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                            // Check if coordinate is valid (in DB or customCoordinates)
-                            if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                                int newGridX = gridX + offset.offsetX;
-                                int newGridY = gridY + offset.offsetY;
+                            // Look up the destination cell (database, custom coordinates or mapping table)
+                            int newGridX = 0, newGridY = 0;
+                            if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                                if (!options.silentMode) {
-                                    logMessage("Found: Interior Door translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                               ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                                }
+                                AB_LOG_DEBUG(LOG_DOORS, logFile, "Found: Interior Door translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                                    gridX, gridY, destX, destY);
 
                                 // New calculation keeping the fractional part for destination translation
                                 double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
@@ -49,10 +72,9 @@ void processInteriorDoorsTranslation(const Database& db, ordered_json& inputData
                                 reference["destination"]["translation"][0] = newDestX;
                                 reference["destination"]["translation"][1] = newDestY;
 
-                                if (!options.silentMode) {
-                                    logMessage("Calculating: new destination -----> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                               ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                                }
+                                AB_LOG_DEBUG(LOG_DOORS, logFile, "Calculating: new destination -----> grid ({}, {}) | coordinates ({:f}, {:f})",
+                                    newGridX, newGridY, newDestX, newDestY);
+                                logRewrite("door", "", cell, gridX, gridY, newGridX, newGridY);
                             }
                         }
                     }
@@ -63,7 +85,7 @@ void processInteriorDoorsTranslation(const Database& db, ordered_json& inputData
 }
 
 // Function to process NPC Travel Service coordinates
-void processNpcTravelDestinations(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processNpcTravelDestinations(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Loop through all objects in inputData
     for (auto& npc : inputData) {
@@ -78,15 +100,12 @@ void processNpcTravelDestinations(const Database& db, ordered_json& inputData, c
                         int gridX = static_cast<int>(std::floor(destX / 8192.0));
                         int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                        // Check if coordinate is valid (in DB or customCoordinates)
-                        if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                            int newGridX = gridX + offset.offsetX;
-                            int newGridY = gridY + offset.offsetY;
+                        // Look up the destination cell (database, custom coordinates or mapping table)
+                        int newGridX = 0, newGridY = 0;
+                        if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                            if (!options.silentMode) {
-                                logMessage("Found: NPC 'Travel Service' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                           ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                            }
+                            AB_LOG_DEBUG(LOG_TRAVEL, logFile, "Found: NPC 'Travel Service' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                                gridX, gridY, destX, destY);
 
                             // New calculation keeping the fractional part for destination coordinates
                             double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
@@ -99,10 +118,9 @@ void processNpcTravelDestinations(const Database& db, ordered_json& inputData, c
                             destination["translation"][0] = newDestX;
                             destination["translation"][1] = newDestY;
 
-                            if (!options.silentMode) {
-                                logMessage("Calculating: new destination ------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                           ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                            }
+                            AB_LOG_DEBUG(LOG_TRAVEL, logFile, "Calculating: new destination ------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                                newGridX, newGridY, newDestX, newDestY);
+                            logRewrite("travel", "", npc, gridX, gridY, newGridX, newGridY);
                         }
                     }
                 }
@@ -112,7 +130,7 @@ void processNpcTravelDestinations(const Database& db, ordered_json& inputData, c
 }
 
 // Function to process Script AI Escort translation
-void processScriptAiEscortTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processScriptAiEscortTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, std::ofstream& logFile) {
 
     // Regular expression to find AiEscort commands
     std::regex aiEscortRegex(R"((AiEscort)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(\d+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)(?:\s*,?\s*(\d+))?)",
@@ -135,33 +153,33 @@ void processScriptAiEscortTranslation(const Database& db, ordered_json& inputDat
                     std::string commandType = match[1].str();
                     std::string actorID = match[2].str();
                     std::string duration = match[3].str();
-                    double destX = std::stod(match[4].str());
-                    double destY = std::stod(match[5].str());
-                    double destZ = std::stod(match[6].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0;
+                    if (!readCommandCoordinates(match, 4, { &destX, &destY, &destZ }, LOG_SCRIPTS, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string resetValue = (match.size() > 7 && match[7].matched) ? match[7].str() : "";
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Script 'AI Escort' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Found: Script 'AI Escort' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ----------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Calculating: new destination ----------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("script", "AI Escort", script, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -205,7 +223,7 @@ void processScriptAiEscortTranslation(const Database& db, ordered_json& inputDat
 }
 
 // Function to process Dialogue AI Escort translation
-void processDialogueAiEscortTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processDialogueAiEscortTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Regular expression to find AiEscort commands
     std::regex aiEscortRegex(R"((AiEscort)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(\d+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)(?:\s*,?\s*(\d+))?)",
@@ -226,33 +244,33 @@ void processDialogueAiEscortTranslation(const Database& db, ordered_json& inputD
                     std::string commandType = match[1].str();
                     std::string actorID = match[2].str();
                     std::string duration = match[3].str();
-                    double destX = std::stod(match[4].str());
-                    double destY = std::stod(match[5].str());
-                    double destZ = std::stod(match[6].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0;
+                    if (!readCommandCoordinates(match, 4, { &destX, &destY, &destZ }, LOG_DIALOGUE, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string resetValue = (match.size() > 7 && match[7].matched) ? match[7].str() : "";
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Dialogue 'AI Escort' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Found: Dialogue 'AI Escort' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Calculating: new destination ------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("dialogue", "AI Escort", dialogueInfo, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -290,7 +308,7 @@ void processDialogueAiEscortTranslation(const Database& db, ordered_json& inputD
 }
 
 // Function to process Script AI Escort Cell translation
-void processScriptAiEscortCellTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processScriptAiEscortCellTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, std::ofstream& logFile) {
 
     // Regular expression to find AiEscortCell commands
     std::regex aiEscortCellRegex(R"((AiEscortCell)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(\d+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)(?:\s*,?\s*(\d+))?)",
@@ -314,33 +332,33 @@ void processScriptAiEscortCellTranslation(const Database& db, ordered_json& inpu
                     std::string actorID = match[2].str();
                     std::string cellID = match[3].str();
                     std::string duration = match[4].str();
-                    double destX = std::stod(match[5].str());
-                    double destY = std::stod(match[6].str());
-                    double destZ = std::stod(match[7].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0;
+                    if (!readCommandCoordinates(match, 5, { &destX, &destY, &destZ }, LOG_SCRIPTS, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string resetValue = (match.size() > 8 && match[8].matched) ? match[8].str() : "";
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Script 'AI Escort Cell' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Found: Script 'AI Escort Cell' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ---------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Calculating: new destination ---------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("script", "AI Escort Cell", script, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -384,7 +402,7 @@ void processScriptAiEscortCellTranslation(const Database& db, ordered_json& inpu
 }
 
 // Function to process Dialogue AI Escort Cell translation
-void processDialogueAiEscortCellTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processDialogueAiEscortCellTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Regular expression to find AiEscortCell commands
     std::regex aiEscortCellRegex(R"((AiEscortCell)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(\d+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)(?:\s*,?\s*(\d+))?)",
@@ -406,33 +424,33 @@ void processDialogueAiEscortCellTranslation(const Database& db, ordered_json& in
                     std::string actorID = match[2].str();
                     std::string cellID = match[3].str();
                     std::string duration = match[4].str();
-                    double destX = std::stod(match[5].str());
-                    double destY = std::stod(match[6].str());
-                    double destZ = std::stod(match[7].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0;
+                    if (!readCommandCoordinates(match, 5, { &destX, &destY, &destZ }, LOG_DIALOGUE, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string resetValue = (match.size() > 8 && match[8].matched) ? match[8].str() : "";
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Dialogue 'AI Escort Cell' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Found: Dialogue 'AI Escort Cell' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination -----------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Calculating: new destination -----------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("dialogue", "AI Escort Cell", dialogueInfo, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -470,7 +488,7 @@ void processDialogueAiEscortCellTranslation(const Database& db, ordered_json& in
 }
 
 // Function to process Script AI Follow translation
-void processScriptAiFollowTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processScriptAiFollowTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, std::ofstream& logFile) {
 
     // Regular expression to find AiFollow commands
     std::regex aiFollowRegex(R"((AiFollow)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(\d+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)(?:\s*,?\s*(\d+))?)",
@@ -493,33 +511,33 @@ void processScriptAiFollowTranslation(const Database& db, ordered_json& inputDat
                     std::string commandType = match[1].str();
                     std::string actorID = match[2].str();
                     std::string duration = match[3].str();
-                    double destX = std::stod(match[4].str());
-                    double destY = std::stod(match[5].str());
-                    double destZ = std::stod(match[6].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0;
+                    if (!readCommandCoordinates(match, 4, { &destX, &destY, &destZ }, LOG_SCRIPTS, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string resetValue = (match.size() > 7 && match[7].matched) ? match[7].str() : "";
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Script 'AI Follow' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Found: Script 'AI Follow' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ----------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Calculating: new destination ----------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("script", "AI Follow", script, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -563,7 +581,7 @@ void processScriptAiFollowTranslation(const Database& db, ordered_json& inputDat
 }
 
 // Function to process Dialogue AI Follow translation
-void processDialogueAiFollowTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processDialogueAiFollowTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Regular expression to find AiFollow commands
     std::regex aiFollowRegex(R"((AiFollow)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(\d+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)(?:\s*,?\s*(\d+))?)",
@@ -584,33 +602,33 @@ void processDialogueAiFollowTranslation(const Database& db, ordered_json& inputD
                     std::string commandType = match[1].str();
                     std::string actorID = match[2].str();
                     std::string duration = match[3].str();
-                    double destX = std::stod(match[4].str());
-                    double destY = std::stod(match[5].str());
-                    double destZ = std::stod(match[6].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0;
+                    if (!readCommandCoordinates(match, 4, { &destX, &destY, &destZ }, LOG_DIALOGUE, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string resetValue = (match.size() > 7 && match[7].matched) ? match[7].str() : "";
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Dialogue 'AI Follow' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Found: Dialogue 'AI Follow' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Calculating: new destination ------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("dialogue", "AI Follow", dialogueInfo, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -648,7 +666,7 @@ void processDialogueAiFollowTranslation(const Database& db, ordered_json& inputD
 }
 
 // Function to process Script AI Follow Cell translation
-void processScriptAiFollowCellTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processScriptAiFollowCellTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, std::ofstream& logFile) {
 
     // Regular expression to find AiFollow commands
     std::regex aiFollowCellRegex(R"((AIFollowCell)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(\d+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)(?:\s*,?\s*(\d+))?)",
@@ -671,33 +689,33 @@ void processScriptAiFollowCellTranslation(const Database& db, ordered_json& inpu
                     std::string actorID = match[2].str();
                     std::string cellID = match[3].str();
                     std::string duration = match[4].str();
-                    double destX = std::stod(match[5].str());
-                    double destY = std::stod(match[6].str());
-                    double destZ = std::stod(match[7].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0;
+                    if (!readCommandCoordinates(match, 5, { &destX, &destY, &destZ }, LOG_SCRIPTS, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string resetValue = (match.size() > 8 && match[8].matched) ? match[8].str() : "";
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Script 'AI Follow Cell' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Found: Script 'AI Follow Cell' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ---------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Calculating: new destination ---------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("script", "AI Follow Cell", script, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -741,7 +759,7 @@ void processScriptAiFollowCellTranslation(const Database& db, ordered_json& inpu
 }
 
 // Function to process Dialogue AI Follow Cell translation
-void processDialogueAiFollowCellTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processDialogueAiFollowCellTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Regular expression to find AiFollow commands
     std::regex aiFollowCellRegex(R"((AIFollowCell)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(\d+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)(?:\s*,?\s*(\d+))?)",
@@ -763,33 +781,33 @@ void processDialogueAiFollowCellTranslation(const Database& db, ordered_json& in
                     std::string actorID = match[2].str();
                     std::string cellID = match[3].str();
                     std::string duration = match[4].str();
-                    double destX = std::stod(match[5].str());
-                    double destY = std::stod(match[6].str());
-                    double destZ = std::stod(match[7].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0;
+                    if (!readCommandCoordinates(match, 5, { &destX, &destY, &destZ }, LOG_DIALOGUE, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string resetValue = (match.size() > 8 && match[8].matched) ? match[8].str() : "";
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Dialogue 'AI Follow Cell' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Found: Dialogue 'AI Follow Cell' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination -----------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Calculating: new destination -----------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("dialogue", "AI Follow Cell", dialogueInfo, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -827,7 +845,7 @@ void processDialogueAiFollowCellTranslation(const Database& db, ordered_json& in
 }
 
 // Function to process Script AI Travel translation
-void processScriptAiTravelTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processScriptAiTravelTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, std::ofstream& logFile) {
 
     // Regular expression to find AiTravel commands
     std::regex aiTravelRegex(R"((AiTravel)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)(?:\s*,?\s*(\d+))?)",
@@ -848,33 +866,33 @@ void processScriptAiTravelTranslation(const Database& db, ordered_json& inputDat
 
                 while (std::regex_search(searchStart, scriptText.cend(), match, aiTravelRegex)) {
                     std::string commandType = match[1].str();
-                    double destX = std::stod(match[2].str());
-                    double destY = std::stod(match[3].str());
-                    double destZ = std::stod(match[4].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0;
+                    if (!readCommandCoordinates(match, 2, { &destX, &destY, &destZ }, LOG_SCRIPTS, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string resetValue = (match.size() > 5 && match[5].matched) ? match[5].str() : "";
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Script 'AI Travel' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Found: Script 'AI Travel' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ----------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Calculating: new destination ----------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("script", "AI Travel", script, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -917,7 +935,7 @@ void processScriptAiTravelTranslation(const Database& db, ordered_json& inputDat
 }
 
 // Function to process Dialogue AI Travel translation
-void processDialogueAiTravelTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processDialogueAiTravelTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Regular expression to find AiTravel commands
     std::regex aiTravelRegex(R"((AiTravel)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)(?:\s*,?\s*(\d+))?)",
@@ -936,33 +954,33 @@ void processDialogueAiTravelTranslation(const Database& db, ordered_json& inputD
 
                 while (std::regex_search(searchStart, scriptText.cend(), match, aiTravelRegex)) {
                     std::string commandType = match[1].str();
-                    double destX = std::stod(match[2].str());
-                    double destY = std::stod(match[3].str());
-                    double destZ = std::stod(match[4].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0;
+                    if (!readCommandCoordinates(match, 2, { &destX, &destY, &destZ }, LOG_DIALOGUE, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string resetValue = (match.size() > 5 && match[5].matched) ? match[5].str() : "";
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Dialogue 'AI Travel' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Found: Dialogue 'AI Travel' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Calculating: new destination ------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("dialogue", "AI Travel", dialogueInfo, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -995,7 +1013,7 @@ void processDialogueAiTravelTranslation(const Database& db, ordered_json& inputD
 }
 
 // Function to process Script Position translation
-void processScriptPositionTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processScriptPositionTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, std::ofstream& logFile) {
 
     // Regular expression to find Position commands
     std::regex positionRegex(R"((Position)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?))",
@@ -1016,33 +1034,32 @@ void processScriptPositionTranslation(const Database& db, ordered_json& inputDat
 
                 while (std::regex_search(searchStart, scriptText.cend(), match, positionRegex)) {
                     std::string commandType = match[1].str();
-                    double destX = std::stod(match[2].str());
-                    double destY = std::stod(match[3].str());
-                    double destZ = std::stod(match[4].str());
-                    double zRot = std::stod(match[5].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0, zRot = 0.0;
+                    if (!readCommandCoordinates(match, 2, { &destX, &destY, &destZ, &zRot }, LOG_SCRIPTS, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Script 'Position' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Found: Script 'Position' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ---------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Calculating: new destination ---------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("script", "Position", script, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -1082,7 +1099,7 @@ void processScriptPositionTranslation(const Database& db, ordered_json& inputDat
 }
 
 // Function to process Dialogue Position translation
-void processDialoguePositionTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processDialoguePositionTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Regular expression to find Position commands
     std::regex positionRegex(R"((Position)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?))",
@@ -1101,31 +1118,32 @@ void processDialoguePositionTranslation(const Database& db, ordered_json& inputD
 
                 while (std::regex_search(searchStart, scriptText.cend(), match, positionRegex)) {
                     std::string commandType = match[1].str();
-                    double destX = std::stod(match[2].str());
-                    double destY = std::stod(match[3].str());
-                    double destZ = std::stod(match[4].str());
-                    double zRot = std::stod(match[5].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0, zRot = 0.0;
+                    if (!readCommandCoordinates(match, 2, { &destX, &destY, &destZ, &zRot }, LOG_DIALOGUE, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Dialogue 'Position' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Found: Dialogue 'Position' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        logMessage("Calculating: new destination -----------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                   ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Calculating: new destination -----------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("dialogue", "Position", dialogueInfo, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -1155,7 +1173,7 @@ void processDialoguePositionTranslation(const Database& db, ordered_json& inputD
 }
 
 // Function to process Script PositionCell translation
-void processScriptPositionCellTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processScriptPositionCellTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, std::ofstream& logFile) {
 
     // Regular expression to find PositionCell commands
     std::regex positionCellRegex(R"((PositionCell)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*((?:\"[^\"]+\")|\S+))",
@@ -1176,34 +1194,33 @@ void processScriptPositionCellTranslation(const Database& db, ordered_json& inpu
 
                 while (std::regex_search(searchStart, scriptText.cend(), match, positionCellRegex)) {
                     std::string commandType = match[1].str();
-                    double destX = std::stod(match[2].str());
-                    double destY = std::stod(match[3].str());
-                    double destZ = std::stod(match[4].str());
-                    double zRot = std::stod(match[5].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0, zRot = 0.0;
+                    if (!readCommandCoordinates(match, 2, { &destX, &destY, &destZ, &zRot }, LOG_SCRIPTS, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string cellID = match[6].str();
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Script 'Position Cell' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Found: Script 'Position Cell' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination --------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Calculating: new destination --------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("script", "Position Cell", script, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -1244,7 +1261,7 @@ void processScriptPositionCellTranslation(const Database& db, ordered_json& inpu
 }
 
 // Function to process Dialogue PositionCell translation
-void processDialoguePositionCellTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processDialoguePositionCellTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Regular expression to find PositionCell commands
     std::regex positionCellRegex(R"((PositionCell)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*((?:\"[^\"]+\")|\S+))",
@@ -1263,34 +1280,33 @@ void processDialoguePositionCellTranslation(const Database& db, ordered_json& in
 
                 while (std::regex_search(searchStart, scriptText.cend(), match, positionCellRegex)) {
                     std::string commandType = match[1].str();
-                    double destX = std::stod(match[2].str());
-                    double destY = std::stod(match[3].str());
-                    double destZ = std::stod(match[4].str());
-                    double zRot = std::stod(match[5].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0, zRot = 0.0;
+                    if (!readCommandCoordinates(match, 2, { &destX, &destY, &destZ, &zRot }, LOG_DIALOGUE, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
                     std::string cellID = match[6].str();
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Dialogue 'Position Cell' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Found: Dialogue 'Position Cell' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ----------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Calculating: new destination ----------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("dialogue", "Position Cell", dialogueInfo, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -1325,7 +1341,7 @@ void processDialoguePositionCellTranslation(const Database& db, ordered_json& in
 }
 
 // Function to process Script PlaceItem translation
-void processScriptPlaceItemTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processScriptPlaceItemTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, std::ofstream& logFile) {
 
     // Regular expression to find PlaceItem commands
     std::regex placeItemRegex(R"((PlaceItem)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?))",
@@ -1347,33 +1363,32 @@ void processScriptPlaceItemTranslation(const Database& db, ordered_json& inputDa
                 while (std::regex_search(searchStart, scriptText.cend(), match, placeItemRegex)) {
                     std::string commandType = match[1].str();
                     std::string objectID = match[2].str();
-                    double destX = std::stod(match[3].str());
-                    double destY = std::stod(match[4].str());
-                    double destZ = std::stod(match[5].str());
-                    double zRot = std::stod(match[6].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0, zRot = 0.0;
+                    if (!readCommandCoordinates(match, 3, { &destX, &destY, &destZ, &zRot }, LOG_SCRIPTS, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Script 'Place Item' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Found: Script 'Place Item' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination -----------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Calculating: new destination -----------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("script", "Place Item", script, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -1413,7 +1428,7 @@ void processScriptPlaceItemTranslation(const Database& db, ordered_json& inputDa
 }
 
 // Function to process Dialogue PlaceItem translation
-void processDialoguePlaceItemTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processDialoguePlaceItemTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Regular expression to find PlaceItem commands
     std::regex placeItemRegex(R"((PlaceItem)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?))",
@@ -1433,33 +1448,32 @@ void processDialoguePlaceItemTranslation(const Database& db, ordered_json& input
                 while (std::regex_search(searchStart, scriptText.cend(), match, placeItemRegex)) {
                     std::string commandType = match[1].str();
                     std::string objectID = match[2].str();
-                    double destX = std::stod(match[3].str());
-                    double destY = std::stod(match[4].str());
-                    double destZ = std::stod(match[5].str());
-                    double zRot = std::stod(match[6].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0, zRot = 0.0;
+                    if (!readCommandCoordinates(match, 3, { &destX, &destY, &destZ, &zRot }, LOG_DIALOGUE, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Dialogue 'Place Item' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Found: Dialogue 'Place Item' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination -------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Calculating: new destination -------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("dialogue", "Place Item", dialogueInfo, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -1493,7 +1507,7 @@ void processDialoguePlaceItemTranslation(const Database& db, ordered_json& input
 }
 
 // Function to process Script PlaceItemCell translation
-void processScriptPlaceItemCellTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processScriptPlaceItemCellTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, std::ofstream& logFile) {
 
     // Regular expression to find PlaceItemCell commands
     std::regex placeItemCellRegex(R"((PlaceItemCell)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?))",
@@ -1516,33 +1530,32 @@ void processScriptPlaceItemCellTranslation(const Database& db, ordered_json& inp
                     std::string commandType = match[1].str();
                     std::string objectID = match[2].str();
                     std::string cellID = match[3].str();
-                    double destX = std::stod(match[4].str());
-                    double destY = std::stod(match[5].str());
-                    double destZ = std::stod(match[6].str());
-                    double zRot = std::stod(match[7].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0, zRot = 0.0;
+                    if (!readCommandCoordinates(match, 4, { &destX, &destY, &destZ, &zRot }, LOG_SCRIPTS, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Script 'Place Item Cell' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Found: Script 'Place Item Cell' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ----------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_SCRIPTS, logFile, "Calculating: new destination ----------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("script", "Place Item Cell", script, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -1582,7 +1595,7 @@ void processScriptPlaceItemCellTranslation(const Database& db, ordered_json& inp
 }
 
 // Function to process Dialogue PlaceItemCell translation
-void processDialoguePlaceItemCellTranslation(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processDialoguePlaceItemCellTranslation(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::ofstream& logFile) {
 
     // Regular expression to find PlaceItemCell commands
     std::regex placeItemCellRegex(R"((PlaceItemCell)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*((?:\"[^\"]+\")|\S+)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?)\s*,?\s*(-?\d+(?:\.\d+)?))",
@@ -1603,33 +1616,32 @@ void processDialoguePlaceItemCellTranslation(const Database& db, ordered_json& i
                     std::string commandType = match[1].str();
                     std::string objectID = match[2].str();
                     std::string cellID = match[3].str();
-                    double destX = std::stod(match[4].str());
-                    double destY = std::stod(match[5].str());
-                    double destZ = std::stod(match[6].str());
-                    double zRot = std::stod(match[7].str());
+                    double destX = 0.0, destY = 0.0, destZ = 0.0, zRot = 0.0;
+                    if (!readCommandCoordinates(match, 4, { &destX, &destY, &destZ, &zRot }, LOG_DIALOGUE, logFile)) {
+                        // Leave a command with an unreadable literal unchanged
+                        updatedText += scriptText.substr(searchStart - scriptText.cbegin(), match.position()) + match.str();
+                        searchStart = match.suffix().first;
+                        continue;
+                    }
 
                     // Round only the integer part for grid coordinates
                     int gridX = static_cast<int>(std::floor(destX / 8192.0));
                     int gridY = static_cast<int>(std::floor(destY / 8192.0));
 
-                    // Check if coordinate is valid (in DB or customCoordinates)
-                    if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-                        int newGridX = gridX + offset.offsetX;
-                        int newGridY = gridY + offset.offsetY;
+                    // Look up the destination cell (database, custom coordinates or mapping table)
+                    int newGridX = 0, newGridY = 0;
+                    if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-                        if (!options.silentMode) {
-                            logMessage("Found: Dialogue 'Place Item Cell' translation -> grid (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                                       ") | coordinates (" + std::to_string(destX) + ", " + std::to_string(destY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Found: Dialogue 'Place Item Cell' translation -> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            gridX, gridY, destX, destY);
 
                         // New calculation keeping the fractional part
                         double newDestX = (newGridX * 8192.0) + (destX - (gridX * 8192.0));
                         double newDestY = (newGridY * 8192.0) + (destY - (gridY * 8192.0));
 
-                        if (!options.silentMode) {
-                            logMessage("Calculating: new destination ------------------> grid (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) +
-                                       ") | coordinates (" + std::to_string(newDestX) + ", " + std::to_string(newDestY) + ")", logFile);
-                        }
+                        AB_LOG_DEBUG(LOG_DIALOGUE, logFile, "Calculating: new destination ------------------> grid ({}, {}) | coordinates ({:f}, {:f})",
+                            newGridX, newGridY, newDestX, newDestY);
+                        logRewrite("dialogue", "Place Item Cell", dialogueInfo, gridX, gridY, newGridX, newGridY);
 
                         // Mark replacement in replacements
                         replacementsFlag = 1;
@@ -1663,10 +1675,10 @@ void processDialoguePlaceItemCellTranslation(const Database& db, ordered_json& i
 }
 
 // Function to search and update the translation block inside the references object
-void processTranslation(ordered_json& jsonData, const GridOffset& offset, int& replacementsFlag, const ProgramOptions& options, std::ofstream& logFile) {
+void processTranslation(ordered_json& jsonData, const GridOffset& offset, int& replacementsFlag, std::ofstream& logFile) {
     // Check if the 'references' key exists and is an array
     if (!jsonData.contains("references") || !jsonData["references"].is_array()) {
-        logMessage("References key is missing or is not an array in JSON.", logFile);
+        AB_LOG_DEBUG(LOG_REFERENCES, logFile, "References key is missing or is not an array in JSON.");
         return;
     }
 
@@ -1684,17 +1696,13 @@ void processTranslation(ordered_json& jsonData, const GridOffset& offset, int& r
             reference["translation"].is_array() &&
             reference["translation"].size() >= 2) {
 
-            if (!options.silentMode) {
-                logMessage("Processing: " + reference.value("id", "Unknown ID"), logFile);
-            }
+            AB_LOG_TRACE(LOG_REFERENCES, logFile, "Processing: {}", reference.value("id", "Unknown ID"));
 
             // Log the original translation values before update
             double originalX = reference["translation"][0].get<double>();
             double originalY = reference["translation"][1].get<double>();
 
-            if (!options.silentMode) {
-                logMessage("Found reference coordinates -> X = " + std::to_string(originalX) + ", Y = " + std::to_string(originalY), logFile);
-            }
+            AB_LOG_TRACE(LOG_REFERENCES, logFile, "Found reference coordinates -> X = {:f}, Y = {:f}", originalX, originalY);
 
             // Apply the offset to the X and Y values (multiplied by 8192 for scaling)
             reference["translation"][0] = originalX + offset.offsetX * 8192;
@@ -1707,20 +1715,17 @@ void processTranslation(ordered_json& jsonData, const GridOffset& offset, int& r
             double updatedX = reference["translation"][0].get<double>();
             double updatedY = reference["translation"][1].get<double>();
 
-            if (!options.silentMode) {
-                logMessage("Calculating new coordinates -> X = " + std::to_string(updatedX) + ", Y = " + std::to_string(updatedY), logFile);
-            }
+            AB_LOG_TRACE(LOG_REFERENCES, logFile, "Calculating new coordinates -> X = {:f}, Y = {:f}", updatedX, updatedY);
         }
         else {
-            if (!options.silentMode) {
-                logMessage("No valid temporary or translation array found in reference: " + reference.value("id", "Unknown ID"), logFile);
-            }
+            AB_LOG_TRACE(LOG_REFERENCES, logFile, "No valid temporary or translation array found in reference: {}",
+                reference.value("id", "Unknown ID"));
         }
     }
 }
 
 // Function to process coordinates for Cell, Landscape, and PathGrid types
-void processGridValues(const Database& db, ordered_json& inputData, const GridOffset& offset, int& replacementsFlag, const std::unordered_set<std::pair<int, int>, PairHash>& customCoordinates, const ProgramOptions& options, std::ofstream& logFile) {
+void processGridValues(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<CellTouch>* touchedCells, std::ofstream& logFile) {
 
     // List of supported types
     std::vector<std::string> typeNames = { "Cell", "Landscape", "PathGrid" };
@@ -1739,7 +1744,7 @@ void processGridValues(const Database& db, ordered_json& inputData, const GridOf
         bool hasDataGrid = item.contains("data") && item["data"].contains("grid") && item["data"]["grid"].is_array();
 
         if (!hasTopLevelGrid && !hasDataGrid) {
-            logMessage("WARNING - grid key is missing for type: " + typeName, logFile);
+            AB_LOG_WARN(LOG_GRID, logFile, "WARNING - grid key is missing for type: {}", typeName);
             continue;
         }
 
@@ -1754,15 +1759,12 @@ void processGridValues(const Database& db, ordered_json& inputData, const GridOf
             gridY = item["data"]["grid"][1].get<int>();
         }
 
-        // Check if coordinate is valid (in DB or customCoordinates)
-        if (isCoordinateValid(db, gridX, gridY, customCoordinates, options, logFile)) {
-            int newGridX = gridX + offset.offsetX;
-            int newGridY = gridY + offset.offsetY;
+        // Look up the destination cell (database, custom coordinates or mapping table)
+        int newGridX = 0, newGridY = 0;
+        if (mapping.find(gridX, gridY, newGridX, newGridY)) {
 
-            if (!options.silentMode) {
-                logMessage("Updating grid coordinates for (" + typeName + "): (" + std::to_string(gridX) + ", " + std::to_string(gridY) +
-                           ") -> (" + std::to_string(newGridX) + ", " + std::to_string(newGridY) + ")", logFile);
-            }
+            AB_LOG_DEBUG(LOG_GRID, logFile, "Updating grid coordinates for ({}): ({}, {}) -> ({}, {})", typeName, gridX, gridY, newGridX, newGridY);
+            logRewrite(typeName == "Cell" ? "cell" : typeName == "Landscape" ? "landscape" : "pathgrid", "", item, gridX, gridY, newGridX, newGridY);
 
             // Update the grid coordinates in the data
             if (hasTopLevelGrid) {
@@ -1776,7 +1778,13 @@ void processGridValues(const Database& db, ordered_json& inputData, const GridOf
 
             // If the type is "Cell", call the processTranslation function to adjust translations
             if (typeName == "Cell") {
-                processTranslation(item, offset, replacementsFlag, options, logFile);
+                processTranslation(item, { newGridX - gridX, newGridY - gridY }, replacementsFlag, logFile);
+            }
+
+            // Remember the moved cell for the cross-plugin conflict report
+            if (touchedCells) {
+                unsigned kind = (typeName == "Cell") ? CELL_TOUCH_CELL : (typeName == "Landscape") ? CELL_TOUCH_LANDSCAPE : CELL_TOUCH_PATHGRID;
+                touchedCells->push_back({ gridX, gridY, newGridX, newGridY, kind });
             }
 
             // Mark that a replacement has been made
@@ -1786,8 +1794,12 @@ void processGridValues(const Database& db, ordered_json& inputData, const GridOf
     }
 }
 
-// Function to log updated script IDs
+// Function to log updated script IDs; the list is part of the summary of a converted file, so it is logged at the
+// warn level and still shown in silent mode
 void logUpdatedScriptIDs(const std::vector<std::string>& updatedScriptIDs, std::ofstream& logFile) {
+    if (!logEnabled(LogLevel::Warn, LOG_SCRIPTS) || !logFile.is_open()) {
+        return;
+    }
     if (updatedScriptIDs.empty()) {
         logMessage("No scripts were updated...", logFile);
         return;
@@ -1807,4 +1819,37 @@ void logUpdatedScriptIDs(const std::vector<std::string>& updatedScriptIDs, std::
     for (const auto& id : uniqueIDs) {
         logMessage("- Script ID: " + id, logFile);
     }
+}
+
+// Function to run all replacement handlers over the input data, each inside its own stage
+void processAllReplacements(const CellMapping& mapping, ordered_json& inputData, int& replacementsFlag, std::vector<std::string>& updatedScriptIDs, StageContext& stageContext, std::ofstream& logFile) {
+    // Helper function to run a replacement handler inside its own stage
+    auto runHandler = [&](const char* name, const auto& handler) {
+        StageScope handlerStage(stageContext, name, "handler");
+        handler();
+        };
+
+    runHandler("processGridValues", [&] { processGridValues(mapping, inputData, replacementsFlag, stageContext.touchedCells, logFile); });
+    runHandler("processInteriorDoorsTranslation", [&] { processInteriorDoorsTranslation(mapping, inputData, replacementsFlag, logFile); });
+    runHandler("processNpcTravelDestinations", [&] { processNpcTravelDestinations(mapping, inputData, replacementsFlag, logFile); });
+
+    runHandler("processScriptAiEscortTranslation", [&] { processScriptAiEscortTranslation(mapping, inputData, replacementsFlag, updatedScriptIDs, logFile); });
+    runHandler("processScriptAiEscortCellTranslation", [&] { processScriptAiEscortCellTranslation(mapping, inputData, replacementsFlag, updatedScriptIDs, logFile); });
+    runHandler("processScriptAiFollowTranslation", [&] { processScriptAiFollowTranslation(mapping, inputData, replacementsFlag, updatedScriptIDs, logFile); });
+    runHandler("processScriptAiFollowCellTranslation", [&] { processScriptAiFollowCellTranslation(mapping, inputData, replacementsFlag, updatedScriptIDs, logFile); });
+    runHandler("processScriptAiTravelTranslation", [&] { processScriptAiTravelTranslation(mapping, inputData, replacementsFlag, updatedScriptIDs, logFile); });
+    runHandler("processScriptPositionTranslation", [&] { processScriptPositionTranslation(mapping, inputData, replacementsFlag, updatedScriptIDs, logFile); });
+    runHandler("processScriptPositionCellTranslation", [&] { processScriptPositionCellTranslation(mapping, inputData, replacementsFlag, updatedScriptIDs, logFile); });
+    runHandler("processScriptPlaceItemTranslation", [&] { processScriptPlaceItemTranslation(mapping, inputData, replacementsFlag, updatedScriptIDs, logFile); });
+    runHandler("processScriptPlaceItemCellTranslation", [&] { processScriptPlaceItemCellTranslation(mapping, inputData, replacementsFlag, updatedScriptIDs, logFile); });
+
+    runHandler("processDialogueAiEscortTranslation", [&] { processDialogueAiEscortTranslation(mapping, inputData, replacementsFlag, logFile); });
+    runHandler("processDialogueAiEscortCellTranslation", [&] { processDialogueAiEscortCellTranslation(mapping, inputData, replacementsFlag, logFile); });
+    runHandler("processDialogueAiFollowTranslation", [&] { processDialogueAiFollowTranslation(mapping, inputData, replacementsFlag, logFile); });
+    runHandler("processDialogueAiFollowCellTranslation", [&] { processDialogueAiFollowCellTranslation(mapping, inputData, replacementsFlag, logFile); });
+    runHandler("processDialogueAiTravelTranslation", [&] { processDialogueAiTravelTranslation(mapping, inputData, replacementsFlag, logFile); });
+    runHandler("processDialoguePositionTranslation", [&] { processDialoguePositionTranslation(mapping, inputData, replacementsFlag, logFile); });
+    runHandler("processDialoguePositionCellTranslation", [&] { processDialoguePositionCellTranslation(mapping, inputData, replacementsFlag, logFile); });
+    runHandler("processDialoguePlaceItemTranslation", [&] { processDialoguePlaceItemTranslation(mapping, inputData, replacementsFlag, logFile); });
+    runHandler("processDialoguePlaceItemCellTranslation", [&] { processDialoguePlaceItemCellTranslation(mapping, inputData, replacementsFlag, logFile); });
 }
\ No newline at end of file
@@ -11,4 +11,17 @@ Database::Database(const std::string& filename) {
     }
 
     db_.reset(db_raw);
-}
\ No newline at end of file
+}
+
+Statement::Statement(sqlite3* db, const char* sql) {
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt_, nullptr) != SQLITE_OK) {
+        const std::string error_msg = sqlite3_errmsg(db);
+        sqlite3_finalize(stmt_);
+        throw std::runtime_error("Failed to prepare query: " + error_msg);
+    }
+}
+
+// Function to run a statement without results
+bool executeSql(sqlite3* db, const char* sql) {
+    return sqlite3_exec(db, sql, nullptr, nullptr, nullptr) == SQLITE_OK;
+}
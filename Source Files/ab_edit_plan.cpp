@@ -0,0 +1,336 @@
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <iomanip>
+#include <map>
+
+#include "ab_edit_plan.h"
+#include "ab_logger.h"
+
+// Helper function to append an object key to a .JSON pointer
+static std::string appendPointerKey(const std::string& path, const std::string& key) {
+    std::string result = path + "/";
+    for (char c : key) {
+        if (c == '~') result += "~0";
+        else if (c == '/') result += "~1";
+        else result += c;
+    }
+    return result;
+}
+
+// Helper function to add the text edits between two strings: one edit per changed line while the line count is kept,
+// otherwise a single edit over the changed middle part
+static void addTextEdits(EditPlan& plan, const EditOperation& locator, const std::string& before, const std::string& after) {
+    auto addSpan = [&](size_t start, const std::string& oldText, const std::string& newText) {
+        size_t prefix = 0;
+        while (prefix < oldText.size() && prefix < newText.size() && oldText[prefix] == newText[prefix]) {
+            ++prefix;
+        }
+        size_t suffix = 0;
+        while (suffix < oldText.size() - prefix && suffix < newText.size() - prefix &&
+               oldText[oldText.size() - 1 - suffix] == newText[newText.size() - 1 - suffix]) {
+            ++suffix;
+        }
+
+        EditOperation operation = locator;
+        operation.offset = start + prefix;
+        operation.oldValue = oldText.substr(prefix, oldText.size() - prefix - suffix);
+        operation.newValue = newText.substr(prefix, newText.size() - prefix - suffix);
+        plan.operations.push_back(std::move(operation));
+    };
+
+    if (std::count(before.begin(), before.end(), '\n') != std::count(after.begin(), after.end(), '\n')) {
+        addSpan(0, before, after);
+        return;
+    }
+
+    size_t beforeStart = 0, afterStart = 0;
+    while (beforeStart <= before.size()) {
+        size_t beforeEnd = before.find('\n', beforeStart);
+        size_t afterEnd = after.find('\n', afterStart);
+        if (beforeEnd == std::string::npos) beforeEnd = before.size();
+        if (afterEnd == std::string::npos) afterEnd = after.size();
+
+        std::string oldLine = before.substr(beforeStart, beforeEnd - beforeStart);
+        std::string newLine = after.substr(afterStart, afterEnd - afterStart);
+        if (oldLine != newLine) {
+            addSpan(beforeStart, oldLine, newLine);
+        }
+
+        beforeStart = beforeEnd + 1;
+        afterStart = afterEnd + 1;
+    }
+}
+
+// Helper function to add the edits between two values at a .JSON pointer
+static void addValueEdits(EditPlan& plan, const EditOperation& locator, const ordered_json& before, const ordered_json& after) {
+    if (before == after) {
+        return;
+    }
+
+    // Descend into objects with the same keys and arrays with the same size
+    if (before.is_object() && after.is_object() && before.size() == after.size()) {
+        bool sameKeys = std::all_of(before.items().begin(), before.items().end(), [&](const auto& item) {
+            return after.contains(item.key());
+            });
+        if (sameKeys) {
+            for (const auto& item : before.items()) {
+                EditOperation child = locator;
+                child.path = appendPointerKey(locator.path, item.key());
+                addValueEdits(plan, child, item.value(), after[item.key()]);
+            }
+            return;
+        }
+    }
+    if (before.is_array() && after.is_array() && before.size() == after.size()) {
+        for (size_t i = 0; i < before.size(); ++i) {
+            EditOperation child = locator;
+            child.path = locator.path + "/" + std::to_string(i);
+            addValueEdits(plan, child, before[i], after[i]);
+        }
+        return;
+    }
+
+    if (before.is_string() && after.is_string()) {
+        addTextEdits(plan, locator, before.get<std::string>(), after.get<std::string>());
+        return;
+    }
+
+    EditOperation operation = locator;
+    operation.oldValue = before;
+    operation.newValue = after;
+    plan.operations.push_back(std::move(operation));
+}
+
+// Function to add the edits turning one record into another to the plan
+void addRecordEdits(EditPlan& plan, size_t recordIndex, const ordered_json& before, const ordered_json& after) {
+    EditOperation locator;
+    locator.record = recordIndex;
+    if (before.is_object()) {
+        locator.type = before.contains("type") && before["type"].is_string() ? before["type"].get<std::string>() : "";
+        locator.id = before.contains("id") && before["id"].is_string() ? before["id"].get<std::string>() : "";
+    }
+    addValueEdits(plan, locator, before, after);
+}
+
+// Function to build the edit plan between two versions of a plugin with the same records
+EditPlan buildEditPlan(const ordered_json& before, const ordered_json& after) {
+    EditPlan plan;
+    for (size_t i = 0; i < before.size() && i < after.size(); ++i) {
+        addRecordEdits(plan, i, before[i], after[i]);
+    }
+    return plan;
+}
+
+// Function to build the plan that undoes a plan (old and new values, hashes and direction swapped)
+EditPlan invertEditPlan(const EditPlan& plan) {
+    EditPlan inverse;
+    inverse.conversionType = plan.conversionType == 1 ? 2 : (plan.conversionType == 2 ? 1 : 0);
+    inverse.inputHash = plan.outputHash;
+    inverse.outputHash = plan.inputHash;
+    inverse.operations = plan.operations;
+
+    // Text edits of the same string move by the length change of the edits before them
+    std::map<std::pair<size_t, std::string>, std::vector<EditOperation*>> textEdits;
+    for (auto& operation : inverse.operations) {
+        std::swap(operation.oldValue, operation.newValue);
+        if (operation.offset) {
+            textEdits[{ operation.record, operation.path }].push_back(&operation);
+        }
+    }
+    for (auto& [key, operations] : textEdits) {
+        std::sort(operations.begin(), operations.end(), [](const EditOperation* a, const EditOperation* b) {
+            return *a->offset < *b->offset;
+            });
+        std::ptrdiff_t shift = 0;
+        for (EditOperation* operation : operations) {
+            *operation->offset += shift;
+            shift += static_cast<std::ptrdiff_t>(operation->oldValue.get_ref<const std::string&>().size()) -
+                     static_cast<std::ptrdiff_t>(operation->newValue.get_ref<const std::string&>().size());
+        }
+    }
+
+    return inverse;
+}
+
+// Function to apply a plan to a plugin; nothing is changed unless every edit matches the plugin
+bool applyEditPlan(ordered_json& plugin, const EditPlan& plan, std::string& error) {
+    if (!plugin.is_array()) {
+        error = "plugin is not a record array";
+        return false;
+    }
+
+    // Verify every edit against the plugin before changing anything
+    std::vector<ordered_json*> targets;
+    targets.reserve(plan.operations.size());
+    for (size_t i = 0; i < plan.operations.size(); ++i) {
+        const EditOperation& operation = plan.operations[i];
+        std::string where = std::format("edit {} (record {}{}{})", i, operation.record, operation.path.empty() ? "" : " ", operation.path);
+
+        if (operation.record >= plugin.size()) {
+            error = where + ": record not found";
+            return false;
+        }
+        ordered_json& record = plugin[operation.record];
+        std::string type = record.contains("type") && record["type"].is_string() ? record["type"].get<std::string>() : "";
+        std::string id = record.contains("id") && record["id"].is_string() ? record["id"].get<std::string>() : "";
+        if (type != operation.type || id != operation.id) {
+            error = where + ": expected " + operation.type + " '" + operation.id + "', found " + type + " '" + id + "'";
+            return false;
+        }
+
+        ordered_json* target = nullptr;
+        try {
+            target = &record.at(ordered_json::json_pointer(operation.path));
+        }
+        catch (const std::exception&) {
+            error = where + ": field not found";
+            return false;
+        }
+
+        if (operation.offset) {
+            if (!target->is_string() || !operation.oldValue.is_string() || !operation.newValue.is_string()) {
+                error = where + ": text edit on a value that is not text";
+                return false;
+            }
+            const std::string& text = target->get_ref<const std::string&>();
+            const std::string& oldText = operation.oldValue.get_ref<const std::string&>();
+            if (*operation.offset > text.size() || text.compare(*operation.offset, oldText.size(), oldText) != 0) {
+                error = where + ": text does not match the plan";
+                return false;
+            }
+        }
+        else if (*target != operation.oldValue) {
+            error = where + ": value does not match the plan";
+            return false;
+        }
+        targets.push_back(target);
+    }
+
+    // Text edits go from the end of each string to its start so the remaining offsets stay valid
+    std::vector<size_t> order(plan.operations.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return plan.operations[a].offset.value_or(0) > plan.operations[b].offset.value_or(0);
+        });
+
+    for (size_t i : order) {
+        const EditOperation& operation = plan.operations[i];
+        if (operation.offset) {
+            std::string& text = targets[i]->get_ref<std::string&>();
+            text.replace(*operation.offset, operation.oldValue.get_ref<const std::string&>().size(),
+                operation.newValue.get_ref<const std::string&>());
+        }
+        else {
+            *targets[i] = operation.newValue;
+        }
+    }
+
+    return true;
+}
+
+// Function to convert an edit plan to .JSON
+ordered_json editPlanToJson(const EditPlan& plan) {
+    ordered_json edits = ordered_json::array();
+    for (const auto& operation : plan.operations) {
+        ordered_json edit;
+        edit["record"] = operation.record;
+        edit["type"] = operation.type;
+        edit["id"] = operation.id;
+        edit["path"] = operation.path;
+        if (operation.offset) {
+            edit["offset"] = *operation.offset;
+        }
+        edit["old"] = operation.oldValue;
+        edit["new"] = operation.newValue;
+        edits.push_back(std::move(edit));
+    }
+
+    ordered_json planJson;
+    planJson["format"] = "tes3ab-edit-plan";
+    planJson["version"] = 1;
+    planJson["conversion_type"] = plan.conversionType;
+    planJson["input_hash"] = plan.inputHash;
+    planJson["output_hash"] = plan.outputHash;
+    planJson["edits"] = std::move(edits);
+    return planJson;
+}
+
+// Function to read an edit plan from .JSON
+bool editPlanFromJson(const ordered_json& planJson, EditPlan& plan, std::string& error) {
+    if (!planJson.is_object() || planJson.value("format", "") != "tes3ab-edit-plan" || planJson.value("version", 0) != 1) {
+        error = "not a version 1 edit plan";
+        return false;
+    }
+
+    try {
+        plan = EditPlan();
+        plan.conversionType = planJson.value("conversion_type", 0);
+        plan.inputHash = planJson.value("input_hash", "");
+        plan.outputHash = planJson.value("output_hash", "");
+        for (const auto& edit : planJson.at("edits")) {
+            EditOperation operation;
+            operation.record = edit.at("record").get<size_t>();
+            operation.type = edit.value("type", "");
+            operation.id = edit.value("id", "");
+            operation.path = edit.at("path").get<std::string>();
+            if (edit.contains("offset")) {
+                operation.offset = edit["offset"].get<size_t>();
+            }
+            operation.oldValue = edit.at("old");
+            operation.newValue = edit.at("new");
+            plan.operations.push_back(std::move(operation));
+        }
+    }
+    catch (const std::exception& e) {
+        error = std::string("invalid edit plan: ") + e.what();
+        return false;
+    }
+
+    return true;
+}
+
+// Function to save an edit plan as a .JSON file
+bool saveEditPlan(const std::filesystem::path& planPath, const EditPlan& plan, std::ofstream& logFile) {
+    std::ofstream outputFile(planPath, std::ios::binary);
+    if (!outputFile) {
+        logMessage("ERROR - failed to save edit plan: " + planPath.string(), logFile);
+        return false;
+    }
+    outputFile << std::setw(2) << editPlanToJson(plan);
+    return true;
+}
+
+// Function to load an edit plan from a .JSON file
+bool loadEditPlan(const std::filesystem::path& planPath, EditPlan& plan, std::ofstream& logFile) {
+    std::ifstream inputFile(planPath, std::ios::binary);
+    if (!inputFile) {
+        logMessage("ERROR - failed to open edit plan: " + planPath.string(), logFile);
+        return false;
+    }
+
+    ordered_json planJson = ordered_json::parse(inputFile, nullptr, false);
+    std::string error;
+    if (planJson.is_discarded() || !editPlanFromJson(planJson, plan, error)) {
+        logMessage("ERROR - failed to read edit plan " + planPath.string() + ": " + (error.empty() ? "invalid .JSON" : error), logFile);
+        return false;
+    }
+    return true;
+}
+
+// Function to hash the contents of a file (FNV-1a 64-bit, hex; empty if the file cannot be read)
+std::string hashFileContents(const std::filesystem::path& filePath) {
+    std::ifstream inputFile(filePath, std::ios::binary);
+    if (!inputFile) {
+        return "";
+    }
+
+    std::uint64_t hash = hashBytes({});
+    char buffer[1 << 16];
+    while (inputFile.read(buffer, sizeof(buffer)) || inputFile.gcount() > 0) {
+        hash = hashBytes(std::string_view(buffer, static_cast<size_t>(inputFile.gcount())), hash);
+    }
+    return std::format("{:016x}", hash);
+}
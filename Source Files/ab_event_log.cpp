@@ -0,0 +1,97 @@
+#include <ctime>
+#include <format>
+#include <random>
+#include <stdexcept>
+
+#include "ab_event_log.h"
+
+// Events are flushed after each plugin, or earlier once this much is buffered
+static constexpr size_t EVENT_BUFFER_LIMIT = 256 * 1024;
+
+// Event log of the calling thread, shared by the handlers and the logger; library calls on other threads never see it
+static thread_local EventLog* currentEventLog = nullptr;
+
+// Helper function to make a run id from the UTC start time and a random suffix
+static std::string makeRunId() {
+    std::time_t now = std::time(nullptr);
+    char timestamp[32] = {};
+    std::strftime(timestamp, sizeof(timestamp), "%Y%m%dT%H%M%SZ", std::gmtime(&now));
+    std::random_device random;
+    return std::format("{}-{:04x}", timestamp, random() & 0xffff);
+}
+
+// Constructor that opens the event file for appending (throws std::runtime_error)
+EventLog::EventLog(const std::filesystem::path& eventPath)
+    : output_(eventPath, std::ios::binary | std::ios::app), runId_(makeRunId()), start_(std::chrono::steady_clock::now()) {
+    if (!output_) {
+        throw std::runtime_error("Failed to open event log: " + eventPath.string());
+    }
+    buffer_.reserve(EVENT_BUFFER_LIMIT);
+}
+
+// Destructor that writes out the buffered events
+EventLog::~EventLog() {
+    flush();
+}
+
+// Add an event; the fields are merged after the common ones
+void EventLog::emit(const char* type, ordered_json fields) {
+    ordered_json event;
+    event["run"] = runId_;
+    event["seq"] = ++sequence_;
+    event["t"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    event["event"] = type;
+    if (!file_.empty()) {
+        event["file"] = file_;
+    }
+    for (auto& [key, value] : fields.items()) {
+        event[key] = std::move(value);
+    }
+
+    buffer_ += event.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
+    buffer_ += '\n';
+    if (buffer_.size() >= EVENT_BUFFER_LIMIT) {
+        flush();
+    }
+}
+
+// Write the buffered events to the file
+void EventLog::flush() {
+    if (!buffer_.empty()) {
+        output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        output_.flush();
+        buffer_.clear();
+    }
+}
+
+// Function to set the event log the handlers and the logger of the calling thread report to (nullptr: none)
+void setEventLog(EventLog* events) {
+    currentEventLog = events;
+}
+
+// Function to get the active event log of the calling thread (nullptr when events are not recorded)
+EventLog* activeEventLog() {
+    return currentEventLog;
+}
+
+// Function to record a coordinate rewrite of a handler in the active event log
+void logRewrite(const char* kind, const char* command, const ordered_json& record, int gridX, int gridY, int newGridX, int newGridY) {
+    if (!currentEventLog) {
+        return;
+    }
+
+    ordered_json fields;
+    fields["kind"] = kind;
+    if (command[0] != '\0') {
+        fields["command"] = command;
+    }
+    for (const char* key : { "id", "name" }) {
+        if (record.contains(key) && record[key].is_string() && !record[key].get_ref<const std::string&>().empty()) {
+            fields["record"] = record[key];
+            break;
+        }
+    }
+    fields["old_grid"] = { gridX, gridY };
+    fields["new_grid"] = { newGridX, newGridY };
+    currentEventLog->emit("rewrite", std::move(fields));
+}
@@ -97,8 +97,7 @@ bool addConversionTag(ordered_json& inputData, const std::string& convPrefix, co
 }
 
 // Function to create backup with automatic numbering
-bool createBackup(const std::filesystem::path& filePath, const ProgramOptions& options, std::ofstream& logFile) {
-    std::filesystem::path backupPath;
+bool createBackup(const std::filesystem::path& filePath, std::filesystem::path& backupPath, const ProgramOptions& options, std::ofstream& logFile) {
     int counter = 0;
     const int maxBackups = 1000;
 
@@ -146,13 +145,11 @@ bool saveJsonToFile(const std::filesystem::path& jsonImportPath, const ordered_j
 }
 
 // Function to convert the .JSON file to .ESP|ESM
-bool convertJsonToEsp(const std::filesystem::path& jsonImportPath, const std::filesystem::path& espFilePath, const ProgramOptions& options, std::ofstream& logFile) {
-    std::ostringstream command;
-    command << TES3CONV_COMMAND << " "
-            << std::quoted(jsonImportPath.string()) << " "
-            << std::quoted(espFilePath.string());
+bool convertJsonToEsp(const std::filesystem::path& jsonImportPath, const std::filesystem::path& espFilePath, ProcessResult& encodeResult,
+    const ProgramOptions& options, std::ofstream& logFile) {
+    encodeResult = runTes3conv(jsonImportPath, espFilePath);
 
-    if (std::system(command.str().c_str()) != 0) {
+    if (!encodeResult.started || encodeResult.exitCode != 0) {
         return false;
     }
 
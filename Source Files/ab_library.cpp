@@ -0,0 +1,355 @@
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "ab_data_processor.h"
+#include "ab_event_log.h"
+#include "ab_file_processor.h"
+#include "ab_library.h"
+#include "ab_logger.h"
+
+// Constructor that opens the database and loads the custom grid coordinates (throws std::runtime_error)
+CoordinateIndex::CoordinateIndex(const std::string& databasePath, const std::string& customCoordinatesPath)
+    : db_(databasePath) {
+    if (!std::filesystem::exists(customCoordinatesPath)) {
+        throw std::runtime_error("Custom grid coordinates file not found: " + customCoordinatesPath);
+    }
+
+    // A closed log stream keeps the library quiet; the library never writes the compiled cache
+    std::ofstream quietLog;
+    loadCustomGridCoordinates(customCoordinatesPath, customCoordinates_, false, quietLog);
+    buildAnthologyProfile();
+}
+
+// Constructor that takes over an already opened database and loaded custom grid coordinates
+CoordinateIndex::CoordinateIndex(Database&& db, std::unordered_set<std::pair<int, int>, PairHash>&& customCoordinates)
+    : db_(std::move(db)), customCoordinates_(std::move(customCoordinates)) {
+    buildAnthologyProfile();
+}
+
+// Build the built-in profile for both directions
+void CoordinateIndex::buildAnthologyProfile() {
+    std::ofstream quietLog;
+    forward_ = buildAnthologyMapping(db_, customCoordinates_, 1, quietLog);
+    reverse_ = buildAnthologyMapping(db_, customCoordinates_, 2, quietLog);
+}
+
+// Replace the built-in Anthology Bloodmoon profile with a mapping table (conversion type 1; type 2 uses its inverse)
+void CoordinateIndex::useMappingTable(std::vector<CellMappingEntry> entries) {
+    forward_ = CellMapping(std::move(entries));
+    reverse_ = forward_.inverted();
+}
+
+// Function to get the report reason of an outcome ("converted" for success)
+const char* conversionOutcomeReason(ConversionOutcome outcome) {
+    switch (outcome) {
+    case ConversionOutcome::Converted: return "converted";
+    case ConversionOutcome::AlreadyConverted: return "already converted";
+    case ConversionOutcome::MissingMasters: return "missing Parent Masters";
+    case ConversionOutcome::NoReplacements: return "no replacements";
+    case ConversionOutcome::NoHeaderDescription: return "header description not found";
+    default: return "invalid .JSON";
+    }
+}
+
+// Function to read the grid of a Cell, Landscape or PathGrid record ("grid" or "data.grid"); false if it has no integer grid
+bool readRecordGrid(const ordered_json& record, int& gridX, int& gridY) {
+    const ordered_json* grid = nullptr;
+    if (record.contains("grid") && record["grid"].is_array()) {
+        grid = &record["grid"];
+    }
+    else if (record.contains("data") && record["data"].is_object() && record["data"].contains("grid") && record["data"]["grid"].is_array()) {
+        grid = &record["data"]["grid"];
+    }
+    if (grid == nullptr || grid->size() < 2 || !(*grid)[0].is_number_integer() || !(*grid)[1].is_number_integer()) {
+        return false;
+    }
+    gridX = (*grid)[0].get<int>();
+    gridY = (*grid)[1].get<int>();
+    return true;
+}
+
+// Helper function to get a field that may be missing (null if it is)
+static const ordered_json& recordField(const ordered_json& record, const char* key) {
+    static const ordered_json missing;
+    return record.contains(key) ? record[key] : missing;
+}
+
+// Helper function to count the lines that differ between two texts; lines are compared by position
+static size_t countChangedLines(const ordered_json& before, const ordered_json& after) {
+    if (!before.is_string() || !after.is_string() || before == after) {
+        return 0;
+    }
+
+    std::istringstream beforeStream(before.get<std::string>());
+    std::istringstream afterStream(after.get<std::string>());
+    std::string beforeLine, afterLine;
+    size_t changed = 0;
+    while (true) {
+        bool hasBefore = static_cast<bool>(std::getline(beforeStream, beforeLine));
+        bool hasAfter = static_cast<bool>(std::getline(afterStream, afterLine));
+        if (!hasBefore && !hasAfter) {
+            break;
+        }
+        if (hasBefore != hasAfter || beforeLine != afterLine) {
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+// Add the counts of another summary
+ChangeSummary& ChangeSummary::operator+=(const ChangeSummary& other) {
+    cells += other.cells;
+    landscapes += other.landscapes;
+    pathGrids += other.pathGrids;
+    references += other.references;
+    doors += other.doors;
+    travelDestinations += other.travelDestinations;
+    scriptCommands += other.scriptCommands;
+    dialogueCommands += other.dialogueCommands;
+    return *this;
+}
+
+// Function to count the changes between two versions of a record (moved grids, references, door and travel
+// destinations, changed script and dialogue result lines)
+void addRecordChanges(ChangeSummary& summary, const ordered_json& before, const ordered_json& after) {
+    if (!before.is_object() || !after.is_object() || before == after) {
+        return;
+    }
+
+    const std::string type = before.value("type", "");
+    if (type == "Cell" || type == "Landscape" || type == "PathGrid") {
+        int beforeX = 0, beforeY = 0, afterX = 0, afterY = 0;
+        if (readRecordGrid(before, beforeX, beforeY) && readRecordGrid(after, afterX, afterY) && (beforeX != afterX || beforeY != afterY)) {
+            if (type == "Cell") ++summary.cells;
+            else if (type == "Landscape") ++summary.landscapes;
+            else ++summary.pathGrids;
+        }
+    }
+
+    if (type == "Cell") {
+        const ordered_json& beforeReferences = recordField(before, "references");
+        const ordered_json& afterReferences = recordField(after, "references");
+        if (beforeReferences.is_array() && afterReferences.is_array() && beforeReferences.size() == afterReferences.size()) {
+            for (size_t i = 0; i < beforeReferences.size(); ++i) {
+                const ordered_json& beforeReference = beforeReferences[i];
+                const ordered_json& afterReference = afterReferences[i];
+                if (!beforeReference.is_object() || !afterReference.is_object()) {
+                    continue;
+                }
+                if (recordField(beforeReference, "translation") != recordField(afterReference, "translation")) {
+                    ++summary.references;
+                }
+                if (recordField(beforeReference, "destination") != recordField(afterReference, "destination")) {
+                    ++summary.doors;
+                }
+            }
+        }
+    }
+    else if (type == "Npc") {
+        const ordered_json& beforeDestinations = recordField(before, "travel_destinations");
+        const ordered_json& afterDestinations = recordField(after, "travel_destinations");
+        if (beforeDestinations.is_array() && afterDestinations.is_array() && beforeDestinations.size() == afterDestinations.size()) {
+            for (size_t i = 0; i < beforeDestinations.size(); ++i) {
+                if (beforeDestinations[i] != afterDestinations[i]) {
+                    ++summary.travelDestinations;
+                }
+            }
+        }
+    }
+    else if (type == "Script") {
+        summary.scriptCommands += countChangedLines(recordField(before, "text"), recordField(after, "text"));
+    }
+    else if (type == "DialogueInfo") {
+        summary.dialogueCommands += countChangedLines(recordField(before, "script_text"), recordField(after, "script_text"));
+    }
+}
+
+// Function to convert a parsed plugin in place (checks, handlers and conversion tag), logging like the CLI does
+ConversionOutcome convertPluginData(ordered_json& plugin, const std::filesystem::path& pluginPath, const CoordinateIndex& index,
+    std::vector<std::string>& updatedScriptIDs, StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile) {
+    return convertPluginData(plugin, pluginPath, index.mapping(options.conversionType), updatedScriptIDs, stageContext, options, logFile);
+}
+
+// Function to convert a parsed plugin in place with an explicit cell mapping (options.conversionType selects the conversion tag)
+ConversionOutcome convertPluginData(ordered_json& plugin, const std::filesystem::path& pluginPath, const CellMapping& mapping,
+    std::vector<std::string>& updatedScriptIDs, StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile) {
+    // Handlers and checks report to the event log of this call, if it has one
+    EventLogScope eventScope(stageContext.events);
+
+    // Check if file was already converted
+    if (hasConversionTag(plugin, pluginPath, logFile)) {
+        return ConversionOutcome::AlreadyConverted;
+    }
+
+    // Check the dependency order
+    auto [isValid, validMasters] = checkDependencyOrder(plugin, logFile);
+    if (!isValid) {
+        return ConversionOutcome::MissingMasters;
+    }
+
+    // Initialize the replacements flag
+    int replacementsFlag = 0;
+
+    // Process replacements with the cell mapping of the conversion choice
+    processAllReplacements(mapping, plugin, replacementsFlag, updatedScriptIDs, stageContext, logFile);
+
+    // Check if any replacements were made
+    if (replacementsFlag == 0) {
+        return ConversionOutcome::NoReplacements;
+    }
+
+    // Log updated script IDs
+    logUpdatedScriptIDs(updatedScriptIDs, logFile);
+
+    // Define conversion prefix
+    std::string convPrefix = (options.conversionType == 1) ? "BM->AB" : "AB->BM";
+
+    // Add conversion tag to header
+    if (!addConversionTag(plugin, convPrefix, options, logFile)) {
+        return ConversionOutcome::NoHeaderDescription;
+    }
+
+    return ConversionOutcome::Converted;
+}
+
+// Function to convert a parsed plugin for several profiles: one traversal picks the records the handlers can touch,
+// each profile converts its own copy of those and keeps the ones it changed
+std::vector<ProfileOutput> convertPluginProfiles(const ordered_json& plugin, const std::filesystem::path& pluginPath,
+    const CoordinateIndex& index, const std::vector<ConversionProfile>& profiles, StageContext& stageContext,
+    const ProgramOptions& options, std::ofstream& logFile) {
+    std::vector<ProfileOutput> outputs(profiles.size());
+    if (!plugin.is_array()) {
+        return outputs;
+    }
+
+    // Record types read or written by the checks and handlers; every other record is never copied
+    static const std::array<const char*, 7> relevantTypes = { "Header", "Cell", "Landscape", "PathGrid", "Npc", "Script", "DialogueInfo" };
+    std::vector<size_t> relevantIndices;
+    for (size_t i = 0; i < plugin.size(); ++i) {
+        const ordered_json& record = plugin[i];
+        if (!record.is_object() || !record.contains("type") || !record["type"].is_string()) {
+            continue;
+        }
+        const std::string& type = record["type"].get_ref<const std::string&>();
+        if (std::find(relevantTypes.begin(), relevantTypes.end(), type) != relevantTypes.end()) {
+            relevantIndices.push_back(i);
+        }
+    }
+
+    for (size_t p = 0; p < profiles.size(); ++p) {
+        const ConversionProfile& profile = profiles[p];
+        ProfileOutput& output = outputs[p];
+
+        ProgramOptions profileOptions = options;
+        profileOptions.conversionType = profile.conversionType;
+        const CellMapping& mapping = profile.mapping ? *profile.mapping : index.mapping(profile.conversionType);
+
+        // Copy the relevant records in their original order
+        ordered_json subset = ordered_json::array();
+        for (size_t i : relevantIndices) {
+            subset.push_back(plugin[i]);
+        }
+
+        // Each profile collects its own moved cells; the caller claims them only for the profiles it applies
+        std::vector<CellTouch>* touchedCells = stageContext.touchedCells;
+        if (touchedCells) {
+            stageContext.touchedCells = &output.touchedCells;
+        }
+
+        AB_LOG_INFO(LOG_GENERAL, logFile, "Applying profile: {}", profile.name);
+        output.outcome = convertPluginData(subset, pluginPath, mapping, output.updatedScriptIDs, stageContext, profileOptions, logFile);
+        stageContext.touchedCells = touchedCells;
+        if (output.outcome != ConversionOutcome::Converted) {
+            output.touchedCells.clear();
+            continue;
+        }
+        for (auto& touch : output.touchedCells) {
+            touch.conversionType = profile.conversionType;
+        }
+
+        // Keep only the records this profile changed
+        for (size_t k = 0; k < relevantIndices.size(); ++k) {
+            if (subset[k] != plugin[relevantIndices[k]]) {
+                output.records.emplace_back(relevantIndices[k], std::move(subset[k]));
+            }
+        }
+    }
+
+    return outputs;
+}
+
+// Function to swap the records of a profile output into the plugin; swapping again restores the input
+void swapProfileRecords(ordered_json& plugin, ProfileOutput& output) {
+    for (auto& [recordIndex, record] : output.records) {
+        std::swap(plugin[recordIndex], record);
+    }
+}
+
+// Function to convert a parsed plugin (conversionType 1 = BM->AB, 2 = AB->BM) without touching the input
+ConversionResult convertPlugin(const ordered_json& plugin, int conversionType, const CoordinateIndex& index) {
+    ConversionResult result;
+    if (!plugin.is_array() || (conversionType != 1 && conversionType != 2)) {
+        return result;
+    }
+
+    // Everything stays local to the call: options, stages and a closed log stream
+    ProgramOptions options;
+    options.silentMode = true;
+    options.conversionType = conversionType;
+    StageContext stageContext;
+    std::ofstream quietLog;
+
+    result.plugin = plugin;
+    try {
+        result.outcome = convertPluginData(result.plugin, {}, index, result.updatedScriptIDs, stageContext, options, quietLog);
+    }
+    catch (const std::exception& e) {
+        result.outcome = ConversionOutcome::InvalidInput;
+        result.error = e.what();
+    }
+    if (!result.converted()) {
+        result.updatedScriptIDs.clear();
+        result.plugin = plugin;
+        return result;
+    }
+
+    // Handlers never add or remove records, so records can be compared by position
+    for (size_t i = 0; i < plugin.size() && i < result.plugin.size(); ++i) {
+        if (plugin[i] != result.plugin[i]) {
+            const ordered_json& record = result.plugin[i];
+            RecordChange change;
+            change.index = i;
+            change.type = record.contains("type") && record["type"].is_string() ? record["type"].get<std::string>() : "";
+            change.id = record.contains("id") && record["id"].is_string() ? record["id"].get<std::string>() : "";
+            result.changedRecords.push_back(std::move(change));
+            addRecordChanges(result.changes, plugin[i], record);
+            addRecordEdits(result.plan, i, plugin[i], record);
+        }
+    }
+    result.plan.conversionType = conversionType;
+
+    return result;
+}
+
+// Function to convert a raw tes3conv .JSON buffer; the converted buffer (empty unless converted) is serialized the way tes3conv receives it
+ConversionResult convertPluginBuffer(std::string_view buffer, int conversionType, const CoordinateIndex& index) {
+    ordered_json plugin = ordered_json::parse(buffer.begin(), buffer.end(), nullptr, false);
+    if (plugin.is_discarded()) {
+        ConversionResult result;
+        result.error = "failed to parse .JSON";
+        return result;
+    }
+
+    ConversionResult result = convertPlugin(plugin, conversionType, index);
+    if (result.converted()) {
+        std::ostringstream output;
+        output << std::setw(2) << result.plugin;
+        result.buffer = output.str();
+    }
+    return result;
+}
@@ -1,14 +1,171 @@
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
 #include <limits>
+#include <sstream>
+#include <utility>
 
+#ifdef _WIN32
+#include <io.h>
+#include <stdio.h>
+#else
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
+#include "ab_event_log.h"
 #include "ab_logger.h"
 
-// Function to log messages to both a log file and console
+// Console state shared by all log calls (the converter logs from one thread)
+static ConsoleOutput consoleOutput = ConsoleOutput::All;
+static std::string statusLine;
+
+// Helper function to check if a message is a warning or an error
+static bool isWarningOrError(const std::string& message) {
+    size_t start = message.find_first_not_of('\n');
+    if (start == std::string::npos) {
+        return false;
+    }
+    return message.compare(start, 7, "WARNING") == 0 || message.compare(start, 5, "ERROR") == 0;
+}
+
+// Helper function to add a warning or error to the event log, without its prefix and surrounding line breaks
+static void recordMessageEvent(const std::string& message) {
+    const size_t start = message.find_first_not_of('\n');
+    std::string text = start == std::string::npos ? std::string() : message.substr(start);
+    const bool warning = text.compare(0, 7, "WARNING") == 0;
+    if (warning || text.compare(0, 5, "ERROR") == 0) {
+        text.erase(0, warning ? 7 : 5);
+        text.erase(0, text.find_first_not_of(" -"));
+    }
+    text.erase(text.find_last_not_of(" \n") + 1);
+
+    ordered_json fields;
+    fields["message"] = text;
+    activeEventLog()->emit(warning ? "warning" : "error", std::move(fields));
+}
+
+// Helper function to erase the status line before a message is printed
+static void eraseStatusLine() {
+    if (!statusLine.empty() && consoleIsTerminal()) {
+        std::cout << '\r' << std::string(statusLine.size(), ' ') << '\r';
+    }
+}
+
+// Helper function to print the status line again after a message
+static void redrawStatusLine() {
+    if (!statusLine.empty() && consoleIsTerminal()) {
+        std::cout << statusLine << std::flush;
+    }
+}
+
+// Function to log messages to both a log file and console (a closed log stream keeps library calls quiet). The log file
+// is buffered; it is written out when it is closed
 void logMessage(const std::string& message, std::ofstream& logFile) {
-    std::cout << message << std::endl;
-    logFile << message << std::endl;
+    if (!logFile.is_open()) {
+        return;
+    }
+    const bool warningOrError = isWarningOrError(message);
+    if (consoleOutput == ConsoleOutput::All || warningOrError) {
+        eraseStatusLine();
+        std::cout << message << '\n';
+        redrawStatusLine();
+    }
+    logFile << message << '\n';
+
+    if (warningOrError && activeEventLog()) {
+        recordMessageEvent(message);
+    }
+}
+
+// Function to set the most verbose level that is logged
+void setLogLevel(LogLevel level) {
+    log_settings::level = level;
+}
+
+// Function to set the categories that are logged (LogCategory flags)
+void setLogCategories(unsigned categories) {
+    log_settings::categories = categories;
+}
+
+// Function to read a level name (error, warn, info, debug, trace)
+bool parseLogLevel(const std::string& name, LogLevel& level) {
+    static const std::array<std::pair<const char*, LogLevel>, 6> levels = { {
+        { "error", LogLevel::Error }, { "warn", LogLevel::Warn }, { "warning", LogLevel::Warn },
+        { "info", LogLevel::Info }, { "debug", LogLevel::Debug }, { "trace", LogLevel::Trace } } };
+
+    std::string lowered = name;
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), ::tolower);
+    for (const auto& [levelName, value] : levels) {
+        if (lowered == levelName) {
+            level = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to read a comma-separated list of category names (general, grid, references, doors, travel, scripts,
+// dialogue, all)
+bool parseLogCategories(const std::string& list, unsigned& categories) {
+    static const std::array<std::pair<const char*, unsigned>, 8> names = { {
+        { "general", LOG_GENERAL }, { "grid", LOG_GRID }, { "references", LOG_REFERENCES }, { "doors", LOG_DOORS },
+        { "travel", LOG_TRAVEL }, { "scripts", LOG_SCRIPTS }, { "dialogue", LOG_DIALOGUE }, { "all", LOG_ALL } } };
+
+    categories = 0;
+    std::istringstream stream(list);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        name.erase(name.find_last_not_of(" \t") + 1);
+        name.erase(0, name.find_first_not_of(" \t"));
+        auto it = std::find_if(names.begin(), names.end(), [&](const auto& entry) { return name == entry.first; });
+        if (it == names.end()) {
+            return false;
+        }
+        categories |= it->second;
+    }
+    return categories != 0;
+}
+
+// Function to choose which messages reach the console
+void setConsoleOutput(ConsoleOutput output) {
+    consoleOutput = output;
+}
+
+// Function to check if the console is an interactive terminal
+bool consoleIsTerminal() {
+#ifdef _WIN32
+    static const bool terminal = _isatty(_fileno(stdout)) != 0;
+#else
+    static const bool terminal = isatty(fileno(stdout)) != 0;
+#endif
+    return terminal;
+}
+
+// Function to show a status line on the console: redrawn in place on a terminal, one line per call otherwise
+void logStatus(const std::string& status) {
+    if (!consoleIsTerminal()) {
+        std::cout << status << '\n';
+        return;
+    }
+    std::string line = status;
+    if (line.size() < statusLine.size()) {
+        line.append(statusLine.size() - line.size(), ' ');
+    }
+    std::cout << '\r' << line << std::flush;
+    statusLine = status;
+}
+
+// Function to end the status line, leaving its last state on the console
+void logStatusEnd() {
+    if (!statusLine.empty()) {
+        std::cout << '\n';
+        statusLine.clear();
+    }
+    std::cout << std::flush;
 }
 
 // Function to clear log file
@@ -19,6 +176,11 @@ void logClear() {
 
 // Function to log errors, close the database and terminate the program
 [[noreturn]] void logErrorAndExit(const std::string& errorMessage, std::ofstream& logFile) {
+    logStatusEnd();
+    if (activeEventLog()) {
+        recordMessageEvent(errorMessage);
+        activeEventLog()->flush();
+    }
     std::cerr << errorMessage;
     logFile << errorMessage;
     logFile.close();
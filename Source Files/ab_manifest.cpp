@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "ab_logger.h"
+#include "ab_manifest.h"
+
+// Helper function to trim whitespace (and a trailing carriage return) and remove quotes
+static std::string normalizeField(std::string field) {
+    field.erase(std::remove(field.begin(), field.end(), '\"'), field.end());
+    field.erase(field.find_last_not_of(" \t\r") + 1);
+    field.erase(0, field.find_first_not_of(" \t"));
+    return field;
+}
+
+// Helper function to lowercase a string
+static std::string toLower(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+// Helper function to check if a path is a valid .esp or .esm file
+static bool isValidModFile(const std::filesystem::path& path) {
+    std::string ext = toLower(path.extension().string());
+    return ext == ".esp" || ext == ".esm";
+}
+
+// Helper function to read a conversion name (bm-to-ab, ab-to-bm, 1 or 2)
+static bool parseConversionName(const std::string& value, int& conversionType) {
+    const std::string name = toLower(value);
+    if (name == "bm-to-ab" || name == "1") {
+        conversionType = 1;
+        return true;
+    }
+    if (name == "ab-to-bm" || name == "2") {
+        conversionType = 2;
+        return true;
+    }
+    return false;
+}
+
+// Function to apply the overrides of a manifest entry to the options of its file
+void applyManifestEntry(ProgramOptions& options, const ManifestEntry& entry) {
+    if (entry.conversionType != 0) {
+        options.conversionType = entry.conversionType;
+    }
+    if (entry.savePlan) {
+        options.savePlan = *entry.savePlan;
+    }
+    if (entry.savePatch) {
+        options.savePatch = *entry.savePatch;
+    }
+    if (entry.probe) {
+        options.noProbe = !*entry.probe;
+    }
+}
+
+// Function to write a manifest entry as a .JSON manifest line (the object form read by ManifestReader)
+ordered_json manifestEntryToJson(const ManifestEntry& entry) {
+    ordered_json line;
+    line["path"] = entry.path.string();
+    if (entry.conversionType != 0) {
+        line["conversion"] = entry.conversionType == 1 ? "bm-to-ab" : "ab-to-bm";
+    }
+    if (entry.savePlan) {
+        line["save_plan"] = *entry.savePlan;
+    }
+    if (entry.savePatch) {
+        line["save_patch"] = *entry.savePatch;
+    }
+    if (entry.probe) {
+        line["probe"] = *entry.probe;
+    }
+    return line;
+}
+
+// Constructor that opens the manifest (throws std::runtime_error)
+ManifestReader::ManifestReader(const std::filesystem::path& manifestPath)
+    : input_(manifestPath) {
+    if (!input_) {
+        throw std::runtime_error("Failed to open manifest: " + manifestPath.string());
+    }
+}
+
+// Parse one line; returns false (with the reason) if it is invalid
+bool ManifestReader::parseLine(const std::string& line, ManifestEntry& entry, std::string& error) const {
+    // .JSON Lines entry
+    if (line.front() == '{') {
+        ordered_json object = ordered_json::parse(line, nullptr, false);
+        if (object.is_discarded() || !object.is_object()) {
+            error = "invalid .JSON";
+            return false;
+        }
+
+        for (const auto& [key, value] : object.items()) {
+            if (key == "path" && value.is_string()) {
+                entry.path = value.get<std::string>();
+            }
+            else if (key == "conversion" && value.is_number_integer()) {
+                if (!parseConversionName(std::to_string(value.get<int>()), entry.conversionType)) {
+                    error = "unknown conversion: " + value.dump();
+                    return false;
+                }
+            }
+            else if (key == "conversion" && value.is_string()) {
+                if (!parseConversionName(value.get<std::string>(), entry.conversionType)) {
+                    error = "unknown conversion: " + value.get<std::string>();
+                    return false;
+                }
+            }
+            else if ((key == "save_plan" || key == "save_patch" || key == "probe") && value.is_boolean()) {
+                std::optional<bool>& setting = key == "save_plan" ? entry.savePlan : key == "save_patch" ? entry.savePatch : entry.probe;
+                setting = value.get<bool>();
+            }
+            else {
+                error = "invalid field: " + key;
+                return false;
+            }
+        }
+        if (entry.path.empty()) {
+            error = "missing path";
+            return false;
+        }
+        return true;
+    }
+
+    // Plain text entry: path[;conversion[;option...]]
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ';')) {
+        fields.push_back(normalizeField(field));
+    }
+    if (fields.empty() || fields[0].empty()) {
+        error = "missing path";
+        return false;
+    }
+
+    entry.path = fields[0];
+    if (fields.size() > 1 && !fields[1].empty() && !parseConversionName(fields[1], entry.conversionType)) {
+        error = "unknown conversion: " + fields[1];
+        return false;
+    }
+    for (size_t i = 2; i < fields.size(); ++i) {
+        const std::string option = toLower(fields[i]);
+        if (option == "save-plan") entry.savePlan = true;
+        else if (option == "save-patch") entry.savePatch = true;
+        else if (option == "no-probe") entry.probe = false;
+        else if (!option.empty()) {
+            error = "unknown option: " + fields[i];
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read the next plugin; returns false at the end of the manifest. Invalid lines are logged and skipped
+bool ManifestReader::next(ManifestEntry& entry, std::ofstream& logFile) {
+    while (true) {
+        // Continue the directory of the previous line
+        while (directory_ != std::filesystem::recursive_directory_iterator()) {
+            std::filesystem::directory_entry current = *directory_;
+            std::error_code walkError;
+            directory_.increment(walkError);
+            if (walkError) {
+                logMessage("WARNING - manifest line " + std::to_string(directoryEntry_.line) + ": failed to read directory " +
+                           directoryEntry_.path.string() + ": " + walkError.message(), logFile);
+                directory_ = std::filesystem::recursive_directory_iterator();
+            }
+
+            std::error_code fileError;
+            if (current.is_regular_file(fileError) && isValidModFile(current.path())) {
+                entry = directoryEntry_;
+                entry.path = current.path();
+                return true;
+            }
+        }
+
+        std::string line;
+        if (!std::getline(input_, line)) {
+            return false;
+        }
+        ++lineNumber_;
+
+        line = line.substr(0, line.find_last_not_of(" \t\r") + 1);
+        line.erase(0, line.find_first_not_of(" \t"));
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        ManifestEntry parsed;
+        parsed.line = lineNumber_;
+        std::string error;
+        std::error_code pathError;
+        const bool valid = parseLine(line, parsed, error);
+        if (valid && std::filesystem::is_directory(parsed.path, pathError)) {
+            directory_ = std::filesystem::recursive_directory_iterator(parsed.path, pathError);
+            if (!pathError) {
+                directoryEntry_ = std::move(parsed);
+                continue;
+            }
+            error = "failed to read directory " + parsed.path.string() + ": " + pathError.message();
+        }
+        else if (valid && !std::filesystem::exists(parsed.path, pathError)) {
+            error = "input path not found: " + parsed.path.string();
+        }
+        else if (valid && !isValidModFile(parsed.path)) {
+            error = "input file has invalid extension: " + parsed.path.string();
+        }
+        else if (valid) {
+            entry = std::move(parsed);
+            return true;
+        }
+
+        logMessage("WARNING - manifest line " + std::to_string(lineNumber_) + ": " + error, logFile);
+        ++skipped_;
+    }
+}
+
+// Function to count the plugins a manifest names, directories included, without keeping them (0 if it cannot be read)
+size_t countManifestPlugins(const std::filesystem::path& manifestPath) {
+    try {
+        // Invalid lines are reported by the reader of the batch, not twice
+        std::ofstream quietLog;
+        ManifestReader reader(manifestPath);
+        ManifestEntry entry;
+        size_t count = 0;
+        while (reader.next(entry, quietLog)) {
+            ++count;
+        }
+        return count;
+    }
+    catch (const std::exception&) {
+        return 0;
+    }
+}
@@ -0,0 +1,43 @@
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+#include "ab_memory.h"
+
+// Function to read the current resident set size of this process in bytes (0 when unsupported)
+std::uint64_t readCurrentRss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS memoryCounters{};
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters))) {
+        return static_cast<std::uint64_t>(memoryCounters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(__linux__)
+    // /proc/self/statm holds sizes in pages: total, resident, shared, ...
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) {
+        return 0;
+    }
+
+    unsigned long long totalPages = 0, residentPages = 0;
+    int fields = std::fscanf(statm, "%llu %llu", &totalPages, &residentPages);
+    std::fclose(statm);
+
+    if (fields != 2) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(residentPages) * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
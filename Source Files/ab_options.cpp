@@ -26,6 +26,81 @@ ProgramOptions parseArguments(int argc, char* argv[]) {
         else if (argLower == "--ab-to-bm" || argLower == "-2") {
             options.conversionType = 2;
         }
+        else if (argLower == "--report" && i + 1 < argc) {
+            options.reportFile = argv[++i];
+        }
+        else if (argLower == "--trace" && i + 1 < argc) {
+            options.traceFile = argv[++i];
+        }
+        else if (argLower == "--events" && i + 1 < argc) {
+            options.eventFile = argv[++i];
+        }
+        else if (argLower == "--mapping" && i + 1 < argc) {
+            options.mappingFile = argv[++i];
+        }
+        else if (argLower == "--profile" && i + 1 < argc) {
+            options.profileSpecs.emplace_back(argv[++i]);
+        }
+        else if (argLower == "--save-plan") {
+            options.savePlan = true;
+        }
+        else if (argLower == "--apply-plan" && i + 1 < argc) {
+            options.applyPlanFile = argv[++i];
+        }
+        else if (argLower == "--revert-plan" && i + 1 < argc) {
+            options.revertPlanFile = argv[++i];
+        }
+        else if (argLower == "--save-patch") {
+            options.savePatch = true;
+        }
+        else if (argLower == "--apply-patch" && i + 1 < argc) {
+            options.applyPatchFile = argv[++i];
+        }
+        else if (argLower == "--revert-patch" && i + 1 < argc) {
+            options.revertPatchFile = argv[++i];
+        }
+        else if (argLower == "--dry-run") {
+            options.dryRun = true;
+        }
+        else if (argLower == "--index") {
+            options.buildIndex = true;
+        }
+        else if (argLower == "--query-index" && i + 1 < argc) {
+            options.indexQuery = argv[++i];
+        }
+        else if (argLower == "--manifest" && i + 1 < argc) {
+            options.manifestFile = argv[++i];
+        }
+        else if (argLower == "--shard-init" && i + 1 < argc) {
+            options.shardInitDir = argv[++i];
+        }
+        else if (argLower == "--shard" && i + 1 < argc) {
+            options.shardDir = argv[++i];
+        }
+        else if (argLower == "--shard-finalize" && i + 1 < argc) {
+            options.shardFinalizeDir = argv[++i];
+        }
+        else if (argLower == "--claim-timeout" && i + 1 < argc) {
+            options.claimTimeout = argv[++i];
+        }
+        else if (argLower == "--incremental") {
+            options.incremental = true;
+        }
+        else if (argLower == "--no-probe") {
+            options.noProbe = true;
+        }
+        else if (argLower == "--progress") {
+            options.progress = true;
+        }
+        else if (argLower == "--log-level" && i + 1 < argc) {
+            options.logLevel = argv[++i];
+        }
+        else if (argLower == "--log-categories" && i + 1 < argc) {
+            options.logCategories = argv[++i];
+        }
+        else if (argLower == "--perf-counters") {
+            options.perfCounters = true;
+        }
         else if (argLower == "--help" || argLower == "-h") {
             std::cout << "=========================================\n"
                       << "TES3 Anthology Bloodmoon Converter - Help\n"
@@ -41,6 +116,52 @@ ProgramOptions parseArguments(int argc, char* argv[]) {
                       << "  -s, --silent     Suppress non-critical messages (faster conversion)\n"
                       << "  -1, --bm-to-ab   Convert Bloodmoon -> Anthology Bloodmoon\n"
                       << "  -2, --ab-to-bm   Convert Anthology Bloodmoon -> Bloodmoon\n"
+                      << "  --report <file>  Write a .JSON report with per-file timings and tes3conv usage\n"
+                      << "  --trace <file>   Write a Chrome/Perfetto trace of the run (chrome://tracing, ui.perfetto.dev)\n"
+                      << "  --events <file>  Append typed .JSON Lines events of the run (files, stages, coordinate rewrites,\n"
+                      << "                   skips, warnings and errors) to the file, tagged with a run id\n"
+                      << "  --mapping <file> Use a cell mapping table (.txt or .db) instead of the built-in Anthology offset\n"
+                      << "  --profile <name>=<spec>\n"
+                      << "                   Write the converted plugin to a <name> folder next to the original; repeat to\n"
+                      << "                   build several targets from one decode (spec: bm-to-ab, ab-to-bm, optionally\n"
+                      << "                   followed by :<mapping file>)\n"
+                      << "  --save-plan      Save the edits of each converted file as <file>.plan.json next to it\n"
+                      << "  --apply-plan <file>\n"
+                      << "                   Replay a saved edit plan on the file it was made for, without re-analysis\n"
+                      << "  --revert-plan <file>\n"
+                      << "                   Undo a saved edit plan on the converted file\n"
+                      << "  --save-patch     Save a binary patch of each converted file as <file>.abpatch instead of a backup\n"
+                      << "  --apply-patch <file>\n"
+                      << "                   Rebuild the converted file from the original and a binary patch (no tes3conv needed)\n"
+                      << "  --revert-patch <file>\n"
+                      << "                   Restore the original file from the converted file and its binary patch\n"
+                      << "  --dry-run        Only report what would change; no file is saved, backed up or encoded\n"
+                      << "  --index          Add the cells each file touches to the coverage index (only new or changed files are read)\n"
+                      << "  --query-index <cells>\n"
+                      << "                   List the indexed plugins touching the cells (region, or X,Y;X,Y;...) and whether the\n"
+                      << "                   conversion would modify them\n"
+                      << "  --manifest <file>\n"
+                      << "                   Process the plugins listed in a manifest (one path or .JSON object per line,\n"
+                      << "                   optionally with its own conversion) instead of the targets; implies batch mode\n"
+                      << "  --shard-init <dir>\n"
+                      << "                   Queue the targets (or the --manifest) as jobs in a shared job directory\n"
+                      << "  --shard <dir>    Work on the jobs of a job directory together with other processes or hosts\n"
+                      << "  --shard-finalize <dir>\n"
+                      << "                   Merge the results of all workers into one --report (default <dir>/report.json)\n"
+                      << "  --claim-timeout <seconds>\n"
+                      << "                   Requeue jobs whose worker stopped refreshing its claim for this long (default 300)\n"
+                      << "  --incremental    Reuse the records converted from the previous version of each plugin; only\n"
+                      << "                   records that changed since then go through the handlers\n"
+                      << "  --no-probe       Decode every file, even when a scan of the raw plugin finds nothing to convert\n"
+                      << "  --progress       Show a single progress line (files, records/s, MB/s, ETA) instead of the\n"
+                      << "                   detailed messages, which then only go to tes3_ab.log\n"
+                      << "  --log-level <level>\n"
+                      << "                   Most detailed messages to log: error, warn, info, debug (coordinates found and\n"
+                      << "                   calculated) or trace (every moved reference); default trace, warn with -s\n"
+                      << "  --log-categories <list>\n"
+                      << "                   Only log these handlers (comma-separated): general, grid, references, doors,\n"
+                      << "                   travel, scripts, dialogue or all\n"
+                      << "  --perf-counters  Add hardware performance counters to the --report stages (Linux only)\n"
                       << "  -h, --help       Show this help message\n\n"
                       << "Target Formats:\n\n"
                       << "  Single File (works without batch mode):\n"
@@ -0,0 +1,120 @@
+#include <cstring>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "ab_perf_counters.h"
+
+// Name of the counter at the given index, as used in the report
+const char* PerfCounters::counterName(int index) {
+    static const char* const names[PERF_COUNTER_COUNT] = {
+        "cycles", "instructions", "branch_misses", "l1d_read_misses", "llc_misses"
+    };
+    return (index >= 0 && index < PERF_COUNTER_COUNT) ? names[index] : "unknown";
+}
+
+#ifdef __linux__
+
+// Helper function to open a single counter for the calling thread, user space only
+static int openCounter(std::uint32_t type, std::uint64_t config) {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = type;
+    attributes.config = config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+
+PerfCounters::PerfCounters() {
+    const std::uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    const std::array<std::pair<std::uint32_t, std::uint64_t>, PERF_COUNTER_COUNT> events = { {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE, l1dReadMiss },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    } };
+
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+        fds_[i] = openCounter(events[i].first, events[i].second);
+        if (fds_[i] < 0) {
+            if (error_.empty()) {
+                error_ = std::string(counterName(i)) + ": " + std::strerror(errno);
+            }
+            continue;
+        }
+        ioctl(fds_[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+// Read the current (multiplexing-scaled) values of all counters
+PerfCounterValues PerfCounters::read() const {
+    PerfCounterValues result;
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+        if (fds_[i] < 0) {
+            continue;
+        }
+
+        // value, time enabled, time running
+        std::uint64_t data[3] = { 0, 0, 0 };
+        if (::read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+
+        if (data[2] > 0 && data[2] < data[1]) {
+            result.values[i] = static_cast<std::uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+        }
+        else {
+            result.values[i] = data[0];
+        }
+    }
+    return result;
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+    error_ = "hardware performance counters are only supported on Linux";
+}
+
+PerfCounters::~PerfCounters() = default;
+
+// Read the current (multiplexing-scaled) values of all counters
+PerfCounterValues PerfCounters::read() const {
+    return {};
+}
+
+#endif
+
+// Check whether at least one counter could be opened
+bool PerfCounters::available() const {
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+        if (available(i)) return true;
+    }
+    return false;
+}
+
+// Check whether a particular counter could be opened
+bool PerfCounters::available(int index) const {
+    return index >= 0 && index < PERF_COUNTER_COUNT && fds_[index] >= 0;
+}
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <sstream>
+#include <iomanip>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "ab_options.h"
+#include "ab_process.h"
+
+// Function to get the id of the current process
+long long currentProcessId() {
+#ifdef _WIN32
+    return static_cast<long long>(GetCurrentProcessId());
+#else
+    return static_cast<long long>(getpid());
+#endif
+}
+
+// Accumulate usage of another child (max RSS is kept as the peak value)
+ChildUsage& ChildUsage::operator+=(const ChildUsage& other) {
+    runs += other.runs;
+    wallSeconds += other.wallSeconds;
+    userSeconds += other.userSeconds;
+    systemSeconds += other.systemSeconds;
+    maxRssKB = std::max(maxRssKB, other.maxRssKB);
+    blockInputOps += other.blockInputOps;
+    blockOutputOps += other.blockOutputOps;
+    return *this;
+}
+
+#ifdef _WIN32
+// Helper function to convert FILETIME intervals (100 ns units) to seconds
+static double fileTimeToSeconds(const FILETIME& fileTime) {
+    ULARGE_INTEGER value;
+    value.LowPart = fileTime.dwLowDateTime;
+    value.HighPart = fileTime.dwHighDateTime;
+    return static_cast<double>(value.QuadPart) / 1e7;
+}
+#endif
+
+// Function to run an external program, wait for it and collect its resource usage
+ProcessResult runProcess(const std::vector<std::string>& arguments, const std::filesystem::path& workingDirectory,
+    const std::filesystem::path& outputPath) {
+    ProcessResult result;
+    if (arguments.empty()) {
+        return result;
+    }
+
+    result.startTime = std::chrono::steady_clock::now();
+
+#ifdef _WIN32
+    // Build a quoted command line, the same way std::system received it before
+    std::ostringstream commandLine;
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        if (i > 0) commandLine << " ";
+        commandLine << std::quoted(arguments[i]);
+    }
+    std::string command = commandLine.str();
+
+    STARTUPINFOA startupInfo{};
+    startupInfo.cb = sizeof(startupInfo);
+    PROCESS_INFORMATION processInfo{};
+
+    // Redirect stdout and stderr into the output file through an inheritable handle
+    HANDLE outputHandle = INVALID_HANDLE_VALUE;
+    if (!outputPath.empty()) {
+        SECURITY_ATTRIBUTES security{ sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE };
+        outputHandle = CreateFileA(outputPath.string().c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            &security, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (outputHandle == INVALID_HANDLE_VALUE) {
+            return result;
+        }
+        startupInfo.dwFlags |= STARTF_USESTDHANDLES;
+        startupInfo.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+        startupInfo.hStdOutput = outputHandle;
+        startupInfo.hStdError = outputHandle;
+    }
+
+    std::string directory = workingDirectory.string();
+    BOOL created = CreateProcessA(nullptr, command.data(), nullptr, nullptr, outputHandle != INVALID_HANDLE_VALUE, 0, nullptr,
+        directory.empty() ? nullptr : directory.c_str(), &startupInfo, &processInfo);
+    if (outputHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(outputHandle);
+    }
+    if (!created) {
+        return result;
+    }
+    result.started = true;
+    result.processId = static_cast<long long>(processInfo.dwProcessId);
+
+    WaitForSingleObject(processInfo.hProcess, INFINITE);
+
+    DWORD exitCode = 1;
+    GetExitCodeProcess(processInfo.hProcess, &exitCode);
+    result.exitCode = static_cast<int>(exitCode);
+
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetProcessTimes(processInfo.hProcess, &creationTime, &exitTime, &kernelTime, &userTime)) {
+        result.usage.userSeconds = fileTimeToSeconds(userTime);
+        result.usage.systemSeconds = fileTimeToSeconds(kernelTime);
+    }
+
+    PROCESS_MEMORY_COUNTERS memoryCounters{};
+    if (K32GetProcessMemoryInfo(processInfo.hProcess, &memoryCounters, sizeof(memoryCounters))) {
+        result.usage.maxRssKB = static_cast<long long>(memoryCounters.PeakWorkingSetSize / 1024);
+    }
+
+    IO_COUNTERS ioCounters{};
+    if (GetProcessIoCounters(processInfo.hProcess, &ioCounters)) {
+        result.usage.blockInputOps = static_cast<long long>(ioCounters.ReadOperationCount);
+        result.usage.blockOutputOps = static_cast<long long>(ioCounters.WriteOperationCount);
+    }
+
+    CloseHandle(processInfo.hThread);
+    CloseHandle(processInfo.hProcess);
+#else
+    std::vector<char*> argv;
+    argv.reserve(arguments.size() + 1);
+    for (const auto& argument : arguments) {
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+    std::string directory = workingDirectory.string();
+    std::string output = outputPath.string();
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        return result;
+    }
+    if (pid == 0) {
+        if (!directory.empty() && chdir(directory.c_str()) != 0) {
+            _exit(127);
+        }
+        if (!output.empty()) {
+            int fd = open(output.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            if (fd < 0) {
+                _exit(127);
+            }
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    result.started = true;
+    result.processId = static_cast<long long>(pid);
+
+    // wait4 reports the rusage of this particular child, unlike getrusage(RUSAGE_CHILDREN)
+    int status = 0;
+    struct rusage usage {};
+    pid_t waited;
+    do {
+        waited = wait4(pid, &status, 0, &usage);
+    } while (waited < 0 && errno == EINTR);
+
+    if (waited == pid) {
+        if (WIFEXITED(status)) {
+            result.exitCode = WEXITSTATUS(status);
+        }
+        result.usage.userSeconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+        result.usage.systemSeconds = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+        result.usage.maxRssKB = usage.ru_maxrss;
+        result.usage.blockInputOps = usage.ru_inblock;
+        result.usage.blockOutputOps = usage.ru_oublock;
+    }
+#endif
+
+    result.endTime = std::chrono::steady_clock::now();
+    result.usage.runs = 1;
+    result.usage.wallSeconds = std::chrono::duration<double>(result.endTime - result.startTime).count();
+    return result;
+}
+
+// Function to run tes3conv for converting between .ESP|ESM and .JSON
+ProcessResult runTes3conv(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath) {
+    return runProcess({ TES3CONV_COMMAND, inputPath.string(), outputPath.string() });
+}
+
+// Function to format child usage as a single log line
+std::string formatChildUsage(const ChildUsage& usage) {
+    return std::format("{:.3f} s wall, {:.3f} s user, {:.3f} s sys, max RSS {} KB, block I/O {} in / {} out",
+        usage.wallSeconds, usage.userSeconds, usage.systemSeconds, usage.maxRssKB, usage.blockInputOps, usage.blockOutputOps);
+}
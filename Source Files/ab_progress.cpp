@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <format>
+#include <string>
+#include <utility>
+
+#include "ab_logger.h"
+#include "ab_progress.h"
+
+// Helper function to format a duration as [h:]mm:ss
+static std::string formatDuration(double seconds) {
+    const long long total = static_cast<long long>(seconds + 0.5);
+    if (total >= 3600) {
+        return std::format("{}:{:02}:{:02}", total / 3600, (total / 60) % 60, total % 60);
+    }
+    return std::format("{:02}:{:02}", total / 60, total % 60);
+}
+
+// Constructor for a batch of known size (0 files: size unknown, no ETA; 0 bytes: ETA from the files done)
+ProgressLine::ProgressLine(size_t totalFiles, std::uint64_t totalBytes)
+    : totalFiles_(totalFiles), totalBytes_(totalBytes), start_(Clock::now()),
+    interval_(consoleIsTerminal() ? std::chrono::milliseconds(100) : std::chrono::milliseconds(5000)) {
+}
+
+// Read the files of the batch done so far from a shared source (the job directory of shard workers) instead of
+// counting the files of this process; it is only called when the line is drawn
+void ProgressLine::setBatchDone(std::function<size_t()> batchDone) {
+    batchDone_ = std::move(batchDone);
+    batchDoneAtStart_ = batchDone_ ? batchDone_() : 0;
+}
+
+// Draw the first state of the line
+void ProgressLine::fileStarted() {
+    render(!rendered_);
+}
+
+// Count a processed file with its size and number of records
+void ProgressLine::fileFinished(std::uint64_t bytes, size_t records) {
+    ++filesDone_;
+    bytesDone_ += bytes;
+    recordsDone_ += records;
+    render(false);
+}
+
+// Draw the final state and release the console
+void ProgressLine::finish() {
+    render(true);
+    logStatusEnd();
+}
+
+// Draw the status line if the last update is old enough (or always when forced)
+void ProgressLine::render(bool force) {
+    const Clock::time_point now = Clock::now();
+    if (!force && rendered_ && now - lastRender_ < interval_) {
+        return;
+    }
+    lastRender_ = now;
+    rendered_ = true;
+
+    const double elapsed = std::chrono::duration<double>(now - start_).count();
+    const double recordsPerSecond = elapsed > 0.0 ? recordsDone_ / elapsed : 0.0;
+    const double bytesPerSecond = elapsed > 0.0 ? bytesDone_ / elapsed : 0.0;
+
+    // Files done by every process sharing the batch; the rate of the batch counts only those done since this run started
+    const size_t batchDone = batchDone_ ? std::max(batchDone_(), batchDoneAtStart_) : filesDone_;
+    const size_t doneSinceStart = batchDone - batchDoneAtStart_;
+
+    std::string status = totalFiles_ > 0
+        ? std::format("[{}/{} files]", batchDone, totalFiles_)
+        : std::format("[{} files]", batchDone);
+    status += std::format(" {:.0f} records/s, {:.2f} MB/s", recordsPerSecond, bytesPerSecond / (1024.0 * 1024.0));
+
+    // The remaining time follows the input bytes when their total is known (plugins differ in size far more than in
+    // speed per byte), otherwise the files done
+    if (totalFiles_ > 0 && doneSinceStart > 0) {
+        double remaining = 0.0;
+        if (totalBytes_ > bytesDone_ && bytesPerSecond > 0.0) {
+            remaining = (totalBytes_ - bytesDone_) / bytesPerSecond;
+        }
+        else if (batchDone < totalFiles_) {
+            remaining = elapsed / doneSinceStart * (totalFiles_ - batchDone);
+        }
+        status += ", ETA " + formatDuration(remaining);
+    }
+    logStatus(status);
+}
@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <format>
+#include <stdexcept>
+
+#include "ab_data_processor.h"
+#include "ab_file_processor.h"
+#include "ab_logger.h"
+#include "ab_record_cache.h"
+
+// Add the counts of another plugin
+RecordCacheStats& RecordCacheStats::operator+=(const RecordCacheStats& other) {
+    records += other.records;
+    reused += other.reused;
+    return *this;
+}
+
+// Function to fingerprint a conversion (direction and every mapped cell), so records are only reused for the same conversion;
+// the program version is part of it, so a converter update never reuses records converted by older handlers
+std::string conversionFingerprint(const CellMapping& mapping, int conversionType) {
+    std::string data = PROGRAM_VERSION + ";" + std::to_string(conversionType);
+    for (const auto& entry : mapping.entries()) {
+        data += std::format(";{},{},{},{}", entry.sourceX, entry.sourceY, entry.destX, entry.destY);
+    }
+    return std::format("{:016x}", hashBytes(data));
+}
+
+// Constructor that opens or creates the cache for one conversion (throws std::runtime_error)
+RecordCache::RecordCache(const std::string& cachePath, std::string conversionKey)
+    : db_(cachePath), conversionKey_(std::move(conversionKey)) {
+    bool created = executeSql(db_, "PRAGMA journal_mode=WAL;") &&
+        executeSql(db_, "CREATE TABLE IF NOT EXISTS records ("
+                "plugin TEXT NOT NULL, conversion TEXT NOT NULL, hash INTEGER NOT NULL, size INTEGER NOT NULL, converted TEXT NOT NULL, "
+                "PRIMARY KEY (plugin, conversion, hash, size)) WITHOUT ROWID;");
+    if (!created) {
+        throw std::runtime_error("Failed to set up record cache: " + std::string(sqlite3_errmsg(db_)));
+    }
+}
+
+// Load the cached records of a plugin
+bool RecordCache::load(const std::string& pluginKey, std::unordered_map<RecordKey, std::string, RecordKeyHash>& records) const {
+    records.clear();
+    Statement stmt(db_, "SELECT hash, size, converted FROM records WHERE plugin = ?1 AND conversion = ?2;");
+    stmt.bind(1, pluginKey);
+    stmt.bind(2, conversionKey_);
+
+    int result = SQLITE_ROW;
+    while ((result = stmt.step()) == SQLITE_ROW) {
+        RecordKey key;
+        key.hash = static_cast<std::uint64_t>(sqlite3_column_int64(stmt.get(), 0));
+        key.size = static_cast<std::uint64_t>(sqlite3_column_int64(stmt.get(), 1));
+        const unsigned char* converted = sqlite3_column_text(stmt.get(), 2);
+        records.emplace(key, converted ? reinterpret_cast<const char*>(converted) : "");
+    }
+    return result == SQLITE_DONE;
+}
+
+// Replace the cached records of a plugin with those of its current version
+bool RecordCache::store(const std::string& pluginKey, const std::vector<std::pair<RecordKey, std::string>>& records) {
+    if (!executeSql(db_, "BEGIN;")) {
+        return false;
+    }
+
+    bool stored = true;
+    {
+        Statement remove(db_, "DELETE FROM records WHERE plugin = ?1 AND conversion = ?2;");
+        remove.bind(1, pluginKey);
+        remove.bind(2, conversionKey_);
+        stored = remove.step() == SQLITE_DONE;
+
+        Statement insert(db_, "INSERT OR REPLACE INTO records (plugin, conversion, hash, size, converted) VALUES (?1, ?2, ?3, ?4, ?5);");
+        for (size_t i = 0; stored && i < records.size(); ++i) {
+            insert.bind(1, pluginKey);
+            insert.bind(2, conversionKey_);
+            insert.bind(3, static_cast<std::int64_t>(records[i].first.hash));
+            insert.bind(4, static_cast<std::int64_t>(records[i].first.size));
+            insert.bind(5, records[i].second);
+            stored = insert.step() == SQLITE_DONE;
+            insert.reset();
+        }
+    }
+
+    return executeSql(db_, stored ? "COMMIT;" : "ROLLBACK;") && stored;
+}
+
+// Helper function to get the key of a record version
+static RecordKey recordKey(const ordered_json& record) {
+    const std::string text = record.dump();
+    return { hashBytes(text), text.size() };
+}
+
+// Function to convert a parsed plugin in place, running the handlers only on the records that changed since the cached
+// version of the plugin and reusing the cached result for the rest; the cache is updated unless the plugin is skipped
+// before the handlers run
+ConversionOutcome convertPluginIncremental(ordered_json& plugin, const std::filesystem::path& pluginPath, const CellMapping& mapping,
+    RecordCache& cache, RecordCacheStats& stats, std::vector<std::string>& updatedScriptIDs, StageContext& stageContext,
+    const ProgramOptions& options, std::ofstream& logFile) {
+    if (!plugin.is_array()) {
+        return ConversionOutcome::InvalidInput;
+    }
+
+    // New versions of a plugin keep its file name
+    std::string pluginKey = pluginPath.filename().string();
+    std::transform(pluginKey.begin(), pluginKey.end(), pluginKey.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    std::unordered_map<RecordKey, std::string, RecordKeyHash> cached;
+    {
+        StageScope lookupStage(stageContext, "record cache lookup", "pipeline");
+        if (!cache.load(pluginKey, cached)) {
+            logMessage("WARNING - failed to read the record cache for: " + pluginPath.string(), logFile);
+            cached.clear();
+        }
+    }
+
+    // Split the records the handlers can change into cache hits and records to convert; the header is always converted
+    struct PendingRecord {
+        size_t index = 0;
+        bool cacheable = false;
+        RecordKey key;
+    };
+    struct ReusedRecord {
+        size_t index = 0;
+        RecordKey key;
+        const std::string* converted = nullptr;
+    };
+
+    static const std::array<const char*, 6> cachedTypes = { "Cell", "Landscape", "PathGrid", "Npc", "Script", "DialogueInfo" };
+    std::vector<PendingRecord> pending;
+    std::vector<ReusedRecord> reused;
+    bool reusedChanges = false;
+    {
+        StageScope hashStage(stageContext, "record hash", "pipeline");
+        for (size_t i = 0; i < plugin.size(); ++i) {
+            const ordered_json& record = plugin[i];
+            if (!record.is_object() || !record.contains("type") || !record["type"].is_string()) {
+                continue;
+            }
+            const std::string& type = record["type"].get_ref<const std::string&>();
+            if (type == "Header") {
+                pending.push_back({ i, false, {} });
+                continue;
+            }
+            if (std::find(cachedTypes.begin(), cachedTypes.end(), type) == cachedTypes.end()) {
+                continue;
+            }
+
+            RecordKey key = recordKey(record);
+            ++stats.records;
+            auto hit = cached.find(key);
+            if (hit == cached.end()) {
+                pending.push_back({ i, true, key });
+                continue;
+            }
+
+            ++stats.reused;
+            reused.push_back({ i, key, &hit->second });
+            if (!hit->second.empty()) {
+                reusedChanges = true;
+                if (type == "Script") {
+                    updatedScriptIDs.push_back(record.contains("id") && record["id"].is_string() ? record["id"].get<std::string>() : "Unknown");
+                }
+            }
+        }
+    }
+
+    if (!options.silentMode) {
+        logMessage(std::format("Record cache: reused {} of {} records ({:.1f}%)", stats.reused, stats.records, stats.reuseRatio() * 100.0), logFile);
+    }
+
+    // Run the checks and handlers on the header and the records that are not cached
+    ordered_json subset = ordered_json::array();
+    for (const auto& record : pending) {
+        subset.push_back(plugin[record.index]);
+    }
+    ConversionOutcome outcome = convertPluginData(subset, pluginPath, mapping, updatedScriptIDs, stageContext, options, logFile);
+
+    // Cached records may carry the only replacements of the new version
+    if (outcome == ConversionOutcome::NoReplacements && reusedChanges) {
+        logUpdatedScriptIDs(updatedScriptIDs, logFile);
+        std::string convPrefix = (options.conversionType == 1) ? "BM->AB" : "AB->BM";
+        outcome = addConversionTag(subset, convPrefix, options, logFile) ? ConversionOutcome::Converted : ConversionOutcome::NoHeaderDescription;
+    }
+
+    // Plugins skipped before the handlers ran leave the cache as it was
+    if (outcome == ConversionOutcome::AlreadyConverted || outcome == ConversionOutcome::MissingMasters) {
+        return outcome;
+    }
+
+    // Replace the cached records with those of this version
+    {
+        StageScope storeStage(stageContext, "record cache store", "pipeline");
+        std::vector<std::pair<RecordKey, std::string>> rows;
+        rows.reserve(pending.size() + reused.size());
+        for (size_t k = 0; k < pending.size(); ++k) {
+            if (pending[k].cacheable) {
+                rows.emplace_back(pending[k].key, subset[k] != plugin[pending[k].index] ? subset[k].dump() : std::string());
+            }
+        }
+        for (const auto& record : reused) {
+            rows.emplace_back(record.key, *record.converted);
+        }
+        if (!cache.store(pluginKey, rows)) {
+            logMessage("WARNING - failed to update the record cache for: " + pluginPath.string(), logFile);
+        }
+    }
+
+    if (outcome != ConversionOutcome::Converted) {
+        return outcome;
+    }
+
+    // Put the converted and the reused records in place
+    for (size_t k = 0; k < pending.size(); ++k) {
+        plugin[pending[k].index] = std::move(subset[k]);
+    }
+    for (const auto& record : reused) {
+        if (record.converted->empty()) {
+            continue;
+        }
+
+        ordered_json converted = ordered_json::parse(*record.converted);
+        int gridX = 0, gridY = 0, newGridX = 0, newGridY = 0;
+        if (stageContext.touchedCells && readRecordGrid(plugin[record.index], gridX, gridY) &&
+            readRecordGrid(converted, newGridX, newGridY) && (gridX != newGridX || gridY != newGridY)) {
+            const std::string& type = converted["type"].get_ref<const std::string&>();
+            unsigned kind = (type == "Cell") ? CELL_TOUCH_CELL : (type == "Landscape") ? CELL_TOUCH_LANDSCAPE : CELL_TOUCH_PATHGRID;
+            stageContext.touchedCells->push_back({ gridX, gridY, newGridX, newGridY, kind });
+        }
+        plugin[record.index] = std::move(converted);
+    }
+
+    return ConversionOutcome::Converted;
+}
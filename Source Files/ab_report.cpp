@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <format>
+#include <iomanip>
+
+#include "ab_alloc_stats.h"
+#include "ab_logger.h"
+#include "ab_report.h"
+
+// Helper function to convert child usage into .JSON
+static ordered_json childUsageToJson(const ChildUsage& usage) {
+    ordered_json result;
+    result["runs"] = usage.runs;
+    result["wall_seconds"] = usage.wallSeconds;
+    result["user_seconds"] = usage.userSeconds;
+    result["system_seconds"] = usage.systemSeconds;
+    result["max_rss_kb"] = usage.maxRssKB;
+    result["block_input_ops"] = usage.blockInputOps;
+    result["block_output_ops"] = usage.blockOutputOps;
+    return result;
+}
+
+// Helper function to convert per-stage statistics into .JSON
+static ordered_json stagesToJson(const std::map<std::string, StageStats>& stages, const PerfCounters* perfCounters) {
+    ordered_json result = ordered_json::object();
+    for (const auto& [name, stats] : stages) {
+        ordered_json entry;
+        entry["calls"] = stats.calls;
+        entry["seconds"] = stats.seconds;
+        if (allocationStatsEnabled()) {
+            entry["allocations"] = stats.allocations;
+            entry["allocated_bytes"] = stats.allocatedBytes;
+            entry["peak_live_bytes"] = stats.peakLiveBytes;
+        }
+        if (perfCounters != nullptr) {
+            ordered_json counters;
+            for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+                if (perfCounters->available(i)) {
+                    counters[PerfCounters::counterName(i)] = stats.perfCounts[i];
+                }
+                else {
+                    counters[PerfCounters::counterName(i)] = nullptr;
+                }
+            }
+            entry["counters"] = std::move(counters);
+        }
+        result[name] = std::move(entry);
+    }
+    return result;
+}
+
+// Helper function to convert a change summary into .JSON
+static ordered_json changeSummaryToJson(const ChangeSummary& changes) {
+    ordered_json result;
+    result["cells"] = changes.cells;
+    result["landscapes"] = changes.landscapes;
+    result["path_grids"] = changes.pathGrids;
+    result["references"] = changes.references;
+    result["doors"] = changes.doors;
+    result["travel_destinations"] = changes.travelDestinations;
+    result["script_commands"] = changes.scriptCommands;
+    result["dialogue_commands"] = changes.dialogueCommands;
+    return result;
+}
+
+// Helper function to convert record cache counts into .JSON
+static ordered_json recordCacheToJson(const RecordCacheStats& stats) {
+    ordered_json result;
+    result["records"] = stats.records;
+    result["reused"] = stats.reused;
+    result["reuse_ratio"] = stats.reuseRatio();
+    return result;
+}
+
+// Helper function to convert bytes to MB
+static double toMB(std::uint64_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+// Function to get the peak memory of a file per MB of input (0 when unknown). The peak is the file's own, not the
+// growth over the memory at its start: freed heap stays resident, so files after the largest one would grow by ~0
+double rssPerInputMB(const FileReport& fileReport) {
+    if (fileReport.inputBytes == 0 || fileReport.peakRssBytes == 0) {
+        return 0.0;
+    }
+    return toMB(fileReport.peakRssBytes) / toMB(fileReport.inputBytes);
+}
+
+// Count the files of a status
+size_t RunTotals::count(const std::string& status) const {
+    auto it = statuses.find(status);
+    return it == statuses.end() ? 0 : it->second;
+}
+
+// Function to add a processed file to the totals of a run, and to its files if they are kept
+void addFileReport(RunReport& report, FileReport&& fileReport) {
+    RunTotals& totals = report.totals;
+    ++totals.files;
+    ++totals.statuses[fileReport.status];
+    totals.inProcessSeconds += fileReport.inProcessSeconds;
+    totals.inputBytes += fileReport.inputBytes;
+    totals.recordCount += fileReport.recordCount;
+    totals.peakRssBytes = std::max(totals.peakRssBytes, fileReport.peakRssBytes);
+    if (fileReport.inputBytes > 0 && (totals.worstRssPath.empty() || rssPerInputMB(fileReport) > totals.worstRssPerInputMB)) {
+        totals.worstRssPerInputMB = rssPerInputMB(fileReport);
+        totals.worstRssPath = fileReport.path;
+    }
+    totals.decode += fileReport.decode;
+    totals.encode += fileReport.encode;
+    for (const auto& [name, stats] : fileReport.stages) {
+        totals.stages[name] += stats;
+    }
+    totals.changes += fileReport.changes;
+    totals.recordCache += fileReport.recordCache;
+
+    if (report.keepFiles) {
+        report.files.push_back(std::move(fileReport));
+    }
+}
+
+// Function to split the file time into in-process and tes3conv time
+void finalizeFileReport(FileReport& fileReport, double totalSeconds) {
+    fileReport.totalSeconds = totalSeconds;
+    fileReport.inProcessSeconds = std::max(0.0, totalSeconds - fileReport.decode.wallSeconds - fileReport.encode.wallSeconds);
+}
+
+// Function to log the timings of a single converted file
+void logFileTimings(const FileReport& fileReport, std::ofstream& logFile) {
+    logMessage(std::format("\nFile converted in: {:.3f} seconds", fileReport.totalSeconds), logFile);
+    logMessage(std::format("- converter: {:.3f} seconds", fileReport.inProcessSeconds), logFile);
+    logMessage("- tes3conv decode: " + formatChildUsage(fileReport.decode), logFile);
+    logMessage("- tes3conv encode: " + formatChildUsage(fileReport.encode), logFile);
+    if (fileReport.peakRssBytes > 0) {
+        logMessage(std::format("- memory: peak RSS {:.1f} MB, input {:.2f} MB, {} records, {:.1f} MB per input MB",
+            toMB(fileReport.peakRssBytes), toMB(fileReport.inputBytes), fileReport.recordCount, rssPerInputMB(fileReport)), logFile);
+    }
+    logMessage("", logFile);
+}
+
+// Function to describe a change summary in one line
+std::string formatChangeSummary(const ChangeSummary& changes) {
+    return std::format("{} cells, {} landscapes, {} path grids, {} references, {} doors, {} travel destinations, "
+        "{} script lines, {} dialogue lines", changes.cells, changes.landscapes, changes.pathGrids, changes.references,
+        changes.doors, changes.travelDestinations, changes.scriptCommands, changes.dialogueCommands);
+}
+
+// Function to log the per-batch timing summary
+void logRunSummary(const RunReport& report, std::ofstream& logFile) {
+    const RunTotals& totals = report.totals;
+    if (report.dryRun) {
+        logMessage(std::format("\nDry run: {} of {} files would be converted", totals.count("converted"), totals.files), logFile);
+        logMessage("- changes: " + formatChangeSummary(totals.changes), logFile);
+    }
+
+    if (report.incremental) {
+        const RecordCacheStats& recordCache = totals.recordCache;
+        logMessage(std::format("\nRecord cache: reused {} of {} records ({:.1f}%)", recordCache.reused, recordCache.records,
+            recordCache.reuseRatio() * 100.0), logFile);
+    }
+
+    logMessage(std::format("\nTotal processing time: {:.3f} seconds", report.totalSeconds), logFile);
+    logMessage(std::format("- converter: {:.3f} seconds", totals.inProcessSeconds), logFile);
+    logMessage(std::format("- tes3conv decode ({} runs): ", totals.decode.runs) + formatChildUsage(totals.decode), logFile);
+    logMessage(std::format("- tes3conv encode ({} runs): ", totals.encode.runs) + formatChildUsage(totals.encode), logFile);
+
+    if (totals.peakRssBytes == 0) {
+        return;
+    }
+    logMessage(std::format("- memory: peak RSS {:.1f} MB, input {:.2f} MB", toMB(totals.peakRssBytes), toMB(totals.inputBytes)), logFile);
+
+    if (!totals.worstRssPath.empty()) {
+        logMessage(std::format("- memory per input MB: up to {:.1f} MB ({})", totals.worstRssPerInputMB, totals.worstRssPath.string()), logFile);
+    }
+}
+
+// Function to describe one file of a run as .JSON
+ordered_json fileReportToJson(const FileReport& file, const RunReport& report) {
+    ordered_json entry;
+    entry["path"] = file.path.string();
+    entry["status"] = file.status;
+    if (file.conversionType != 0) {
+        entry["conversion"] = (file.conversionType == 1) ? "BM->AB" : "AB->BM";
+    }
+    if (!file.reason.empty()) {
+        entry["reason"] = file.reason;
+    }
+    if (!file.profiles.empty()) {
+        ordered_json profiles = ordered_json::object();
+        for (const auto& [name, outcome] : file.profiles) {
+            profiles[name] = outcome;
+        }
+        entry["profiles"] = std::move(profiles);
+    }
+    entry["total_seconds"] = file.totalSeconds;
+    entry["in_process_seconds"] = file.inProcessSeconds;
+    entry["input_bytes"] = file.inputBytes;
+    entry["records"] = file.recordCount;
+    entry["rss_baseline_bytes"] = file.baselineRssBytes;
+    entry["rss_peak_bytes"] = file.peakRssBytes;
+    entry["rss_per_input_mb"] = rssPerInputMB(file);
+    entry["tes3conv_decode"] = childUsageToJson(file.decode);
+    entry["tes3conv_encode"] = childUsageToJson(file.encode);
+    entry["stages"] = stagesToJson(file.stages, report.perfCounters);
+    if (report.dryRun) {
+        entry["changes"] = changeSummaryToJson(file.changes);
+    }
+    if (report.incremental) {
+        entry["record_cache"] = recordCacheToJson(file.recordCache);
+    }
+    return entry;
+}
+
+// Function to write the machine-readable run report as .JSON
+bool writeRunReport(const std::filesystem::path& reportPath, const RunReport& report, std::ofstream& logFile) {
+    ordered_json files = ordered_json::array();
+    for (const auto& file : report.files) {
+        files.push_back(fileReportToJson(file, report));
+    }
+
+    const RunTotals& totals = report.totals;
+    ordered_json batch;
+    batch["dry_run"] = report.dryRun;
+    batch["files"] = totals.files;
+    batch["converted"] = totals.count("converted");
+    batch["total_seconds"] = report.totalSeconds;
+    batch["in_process_seconds"] = totals.inProcessSeconds;
+    batch["input_bytes"] = totals.inputBytes;
+    batch["records"] = totals.recordCount;
+    batch["rss_peak_bytes"] = totals.peakRssBytes;
+    batch["rss_per_input_mb_max"] = totals.worstRssPerInputMB;
+    batch["tes3conv_decode"] = childUsageToJson(totals.decode);
+    batch["tes3conv_encode"] = childUsageToJson(totals.encode);
+    if (report.dryRun) {
+        batch["changes"] = changeSummaryToJson(totals.changes);
+    }
+    if (report.incremental) {
+        batch["record_cache"] = recordCacheToJson(totals.recordCache);
+    }
+
+    ordered_json cellConflicts = ordered_json::array();
+    for (const auto& conflict : report.cellConflicts) {
+        ordered_json entry;
+        entry["conversion"] = (conflict.conversionType == 2) ? "AB->BM" : "BM->AB";
+        entry["grid"] = { conflict.gridX, conflict.gridY };
+        entry["new_grid"] = { conflict.newGridX, conflict.newGridY };
+        ordered_json plugins = ordered_json::array();
+        for (const auto& [plugin, kinds] : conflict.plugins) {
+            plugins.push_back({ { "path", plugin }, { "records", formatCellTouchKinds(kinds) } });
+        }
+        entry["plugins"] = std::move(plugins);
+        cellConflicts.push_back(std::move(entry));
+    }
+    batch["cell_conflicts"] = std::move(cellConflicts);
+
+    batch["allocation_stats"] = allocationStatsEnabled();
+    batch["perf_counters"] = report.perfCounters != nullptr;
+    batch["stages"] = stagesToJson(totals.stages, report.perfCounters);
+
+    ordered_json output;
+    output["program"] = PROGRAM_NAME;
+    output["version"] = PROGRAM_VERSION;
+    output["conversion"] = (report.conversionType == 0) ? "per file" : (report.conversionType == 1) ? "BM->AB" : "AB->BM";
+    output["batch"] = std::move(batch);
+    output["files"] = std::move(files);
+
+    std::ofstream reportFile(reportPath);
+    if (!reportFile) {
+        logMessage("ERROR - failed to write report file: " + reportPath.string(), logFile);
+        return false;
+    }
+    reportFile << std::setw(2) << output << "\n";
+    return true;
+}
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <format>
+#include <iomanip>
+#include <map>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ab_logger.h"
+#include "ab_shard.h"
+
+// Waiting workers look for requeued or expired jobs this often
+static constexpr std::chrono::seconds SHARD_POLL_INTERVAL{ 2 };
+
+// Helper function to make a worker id that is unique across the hosts sharing a job directory
+static std::string makeWorkerId() {
+    std::string host;
+#ifdef _WIN32
+    if (const char* computerName = std::getenv("COMPUTERNAME")) {
+        host = computerName;
+    }
+    const int pid = _getpid();
+#else
+    char hostName[256] = {};
+    if (gethostname(hostName, sizeof(hostName) - 1) == 0) {
+        host = hostName;
+    }
+    const int pid = static_cast<int>(getpid());
+#endif
+    // The id becomes part of file names
+    std::replace_if(host.begin(), host.end(), [](unsigned char c) { return !std::isalnum(c) && c != '-' && c != '_'; }, '_');
+    return std::format("{}-{}", host.empty() ? "host" : host, pid);
+}
+
+// Helper function to get the job name of a claim (<n>.job.<worker> -> <n>.job)
+static std::string claimJobName(const std::string& claimName) {
+    const size_t end = claimName.find(".job");
+    return end == std::string::npos ? claimName : claimName.substr(0, end + 4);
+}
+
+// Helper function to count the files in a directory
+static size_t countFiles(const std::filesystem::path& directory) {
+    std::error_code error;
+    size_t count = 0;
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        ++count;
+    }
+    return count;
+}
+
+// Helper function to write a file under a temporary name and rename it into place, so readers never see it half written
+static bool writeFileAtomically(const std::filesystem::path& path, const std::string& content, const std::string& suffix) {
+    const std::filesystem::path temporary = path.string() + ".tmp." + suffix;
+    {
+        std::ofstream output(temporary, std::ios::binary);
+        if (!output || !(output << content)) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+// Function to create the job directory of a sharded batch; fails if it already holds jobs
+bool initShardJobDirectory(const std::filesystem::path& jobDir, std::ofstream& logFile) {
+    std::error_code error;
+    for (const char* name : { "queue", "claimed", "done", "results" }) {
+        std::filesystem::create_directories(jobDir / name, error);
+        if (error) {
+            logMessage("ERROR - failed to create job directory " + (jobDir / name).string() + ": " + error.message(), logFile);
+            return false;
+        }
+        if (countFiles(jobDir / name) != 0) {
+            logMessage("ERROR - job directory already holds jobs: " + (jobDir / name).string(), logFile);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to add one plugin to the queue of a job directory
+bool addShardJob(const std::filesystem::path& jobDir, size_t jobNumber, const ManifestEntry& entry, std::ofstream& logFile) {
+    const std::filesystem::path jobPath = jobDir / "queue" / std::format("{:08}.job", jobNumber);
+    if (!writeFileAtomically(jobPath, manifestEntryToJson(entry).dump() + "\n", "init")) {
+        logMessage("ERROR - failed to write job file: " + jobPath.string(), logFile);
+        return false;
+    }
+    return true;
+}
+
+// Constructor that joins a job directory (throws std::runtime_error)
+ShardWorker::ShardWorker(const std::filesystem::path& jobDir, std::chrono::seconds claimTimeout)
+    : jobDir_(jobDir), claimTimeout_(claimTimeout), workerId_(makeWorkerId()) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(jobDir_ / "queue", error)) {
+        throw std::runtime_error("Not a shard job directory (run --shard-init first): " + jobDir_.string());
+    }
+    for (const char* name : { "claimed", "done", "results" }) {
+        std::filesystem::create_directories(jobDir_ / name, error);
+    }
+    heartbeat_ = std::thread(&ShardWorker::heartbeat, this);
+}
+
+// Destructor that stops refreshing the claims
+ShardWorker::~ShardWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    heartbeat_.join();
+}
+
+// Refresh the file time of the current claim until the worker stops
+void ShardWorker::heartbeat() {
+    const auto interval = std::max<std::chrono::seconds>(std::chrono::seconds(1), claimTimeout_ / 4);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        wake_.wait_for(lock, interval);
+        if (!currentClaim_.empty()) {
+            std::error_code error;
+            std::filesystem::last_write_time(currentClaim_, std::filesystem::file_time_type::clock::now(), error);
+        }
+    }
+}
+
+// Read the names of the queued jobs, in order
+void ShardWorker::listQueue() {
+    pending_.clear();
+    nextPending_ = 0;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(jobDir_ / "queue", error), end; !error && it != end; it.increment(error)) {
+        const std::string name = it->path().filename().string();
+        if (it->path().extension() == ".job") {
+            pending_.push_back(name);
+        }
+    }
+    std::sort(pending_.begin(), pending_.end());
+}
+
+// Move expired claims of other workers back to the queue
+void ShardWorker::requeueExpiredClaims(std::ofstream& logFile) {
+    const auto expiry = std::filesystem::file_time_type::clock::now() - claimTimeout_;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(jobDir_ / "claimed", error), end; !error && it != end; it.increment(error)) {
+        std::error_code timeError;
+        const auto modified = std::filesystem::last_write_time(it->path(), timeError);
+        if (timeError || modified >= expiry) {
+            continue;
+        }
+
+        const std::string claimName = it->path().filename().string();
+        std::error_code renameError;
+        std::filesystem::rename(it->path(), jobDir_ / "queue" / claimJobName(claimName), renameError);
+        if (!renameError) {
+            logMessage("WARNING - claim expired, job requeued: " + claimName, logFile);
+            ++requeued_;
+        }
+    }
+}
+
+// Claim the next job; waits while other workers still hold claims and returns false once every job is done
+bool ShardWorker::claim(ManifestEntry& entry, std::ofstream& logFile) {
+    while (true) {
+        while (nextPending_ < pending_.size()) {
+            const std::string jobName = pending_[nextPending_++];
+            const std::filesystem::path claimPath = jobDir_ / "claimed" / (jobName + "." + workerId_);
+
+            // Only one worker can move the job out of the queue; the others try their next one
+            std::error_code error;
+            std::filesystem::rename(jobDir_ / "queue" / jobName, claimPath, error);
+            if (error) {
+                continue;
+            }
+            std::filesystem::last_write_time(claimPath, std::filesystem::file_time_type::clock::now(), error);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                currentClaim_ = claimPath;
+            }
+            currentJob_ = jobName.substr(0, jobName.size() - 4);
+
+            bool valid = false;
+            try {
+                ManifestReader reader(claimPath);
+                valid = reader.next(entry, logFile);
+            }
+            catch (const std::exception& e) {
+                logMessage(std::string("WARNING - ") + e.what(), logFile);
+            }
+            if (valid) {
+                return true;
+            }
+
+            ordered_json result;
+            result["status"] = "failed";
+            result["reason"] = "invalid job";
+            complete(std::move(result), logFile);
+        }
+
+        requeueExpiredClaims(logFile);
+        listQueue();
+        if (!pending_.empty()) {
+            continue;
+        }
+        if (countFiles(jobDir_ / "claimed") == 0) {
+            return false;
+        }
+        // Other workers are still busy; their jobs come back if they stop refreshing their claims
+        std::this_thread::sleep_for(std::min<std::chrono::seconds>(SHARD_POLL_INTERVAL, claimTimeout_));
+    }
+}
+
+// Store the report entry of the claimed job and mark it as done
+void ShardWorker::complete(ordered_json result, std::ofstream& logFile) {
+    std::filesystem::path claimPath;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        claimPath = currentClaim_;
+        currentClaim_.clear();
+    }
+    if (claimPath.empty()) {
+        return;
+    }
+
+    ordered_json output;
+    output["job"] = currentJob_;
+    output["worker"] = workerId_;
+    for (auto& [key, value] : result.items()) {
+        output[key] = std::move(value);
+    }
+    const std::filesystem::path resultPath = jobDir_ / "results" / (currentJob_ + ".json");
+    if (!writeFileAtomically(resultPath, output.dump(2, ' ', false, nlohmann::detail::error_handler_t::replace) + "\n", workerId_)) {
+        logMessage("ERROR - failed to write job result: " + resultPath.string(), logFile);
+    }
+
+    std::error_code error;
+    std::filesystem::rename(claimPath, jobDir_ / "done" / (currentJob_ + ".job"), error);
+    if (error) {
+        logMessage("WARNING - claim of job " + currentJob_ + " expired before it finished; another worker may repeat it", logFile);
+    }
+    ++jobsDone_;
+}
+
+// Count the jobs of the batch (queued, claimed and done)
+size_t ShardWorker::jobCount() const {
+    return countFiles(jobDir_ / "queue") + countFiles(jobDir_ / "claimed") + countFiles(jobDir_ / "done");
+}
+
+// Count the jobs done by every worker
+size_t ShardWorker::jobsFinished() const {
+    return countFiles(jobDir_ / "done");
+}
+
+// Function to merge the results of all workers into one .JSON report; jobs still queued or claimed are counted
+bool mergeShardResults(const std::filesystem::path& jobDir, const std::filesystem::path& reportPath, std::ofstream& logFile) {
+    std::vector<std::filesystem::path> resultPaths;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(jobDir / "results", error), end; !error && it != end; it.increment(error)) {
+        if (it->path().extension() == ".json") {
+            resultPaths.push_back(it->path());
+        }
+    }
+    if (error) {
+        logMessage("ERROR - failed to read job results: " + (jobDir / "results").string() + ": " + error.message(), logFile);
+        return false;
+    }
+    std::sort(resultPaths.begin(), resultPaths.end());
+
+    ordered_json files = ordered_json::array();
+    std::map<std::string, size_t> statuses;
+    std::map<std::string, size_t> workers;
+    double totalSeconds = 0.0;
+    std::uint64_t inputBytes = 0;
+    std::size_t recordCount = 0;
+    for (const auto& resultPath : resultPaths) {
+        std::ifstream input(resultPath);
+        ordered_json result = ordered_json::parse(input, nullptr, false);
+        if (result.is_discarded() || !result.is_object()) {
+            logMessage("WARNING - invalid job result skipped: " + resultPath.string(), logFile);
+            continue;
+        }
+        ++statuses[result.value("status", "failed")];
+        ++workers[result.value("worker", "")];
+        totalSeconds += result.value("total_seconds", 0.0);
+        inputBytes += result.value("input_bytes", std::uint64_t{ 0 });
+        recordCount += result.value("records", std::size_t{ 0 });
+        files.push_back(std::move(result));
+    }
+
+    const size_t resultCount = files.size();
+    ordered_json batch;
+    batch["files"] = resultCount;
+    for (const char* status : { "converted", "skipped", "failed" }) {
+        batch[status] = statuses[status];
+    }
+    batch["queued"] = countFiles(jobDir / "queue");
+    batch["claimed"] = countFiles(jobDir / "claimed");
+    batch["workers"] = workers;
+    batch["total_seconds"] = totalSeconds;
+    batch["input_bytes"] = inputBytes;
+    batch["records"] = recordCount;
+
+    ordered_json output;
+    output["program"] = PROGRAM_NAME;
+    output["version"] = PROGRAM_VERSION;
+    output["job_directory"] = jobDir.string();
+    output["batch"] = std::move(batch);
+    output["files"] = std::move(files);
+
+    std::ofstream reportFile(reportPath);
+    if (!reportFile) {
+        logMessage("ERROR - failed to write report file: " + reportPath.string(), logFile);
+        return false;
+    }
+    reportFile << std::setw(2) << output << "\n";
+
+    logMessage(std::format("Merged {} job results into {} ({} queued, {} claimed)", resultCount, reportPath.string(),
+                           countFiles(jobDir / "queue"), countFiles(jobDir / "claimed")), logFile);
+    return true;
+}
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <thread>
+
+#include "ab_alloc_stats.h"
+#include "ab_logger.h"
+#include "ab_memory.h"
+#include "ab_options.h"
+#include "ab_trace.h"
+
+TraceRecorder::TraceRecorder()
+    : origin_(std::chrono::steady_clock::now()), processId_(currentProcessId()) {
+}
+
+// Record a finished span; processId 0 means this process
+void TraceRecorder::addSpan(const std::string& name, const std::string& category, const std::string& fileName,
+    std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end, long long processId) {
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.fileName = fileName;
+    event.startMicros = std::chrono::duration_cast<std::chrono::microseconds>(start - origin_).count();
+    event.durationMicros = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    event.processId = processId != 0 ? processId : processId_;
+    event.threadId = processId != 0 ? processId : static_cast<long long>(std::hash<std::thread::id>{}(std::this_thread::get_id()) % 100000);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back(std::move(event));
+}
+
+// Write all recorded events to the trace file
+bool TraceRecorder::writeToFile(const std::filesystem::path& tracePath, std::ofstream& logFile) const {
+    ordered_json traceEvents = ordered_json::array();
+
+    std::set<long long> childProcessIds;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& event : events_) {
+        if (event.processId != processId_) {
+            childProcessIds.insert(event.processId);
+        }
+
+        ordered_json entry;
+        entry["name"] = event.name;
+        entry["cat"] = event.category;
+        entry["ph"] = "X";
+        entry["ts"] = event.startMicros;
+        entry["dur"] = event.durationMicros;
+        entry["pid"] = event.processId;
+        entry["tid"] = event.threadId;
+        if (!event.fileName.empty()) {
+            entry["args"]["file"] = event.fileName;
+        }
+        traceEvents.push_back(std::move(entry));
+    }
+
+    // Name the tracks, so tes3conv children are distinguishable from the converter itself
+    ordered_json processName;
+    processName["name"] = "process_name";
+    processName["ph"] = "M";
+    processName["pid"] = processId_;
+    processName["args"]["name"] = "tes3_ab_converter";
+    traceEvents.push_back(std::move(processName));
+
+    for (long long childProcessId : childProcessIds) {
+        ordered_json childName;
+        childName["name"] = "process_name";
+        childName["ph"] = "M";
+        childName["pid"] = childProcessId;
+        childName["args"]["name"] = "tes3conv";
+        traceEvents.push_back(std::move(childName));
+    }
+
+    ordered_json output;
+    output["displayTimeUnit"] = "ms";
+    output["traceEvents"] = std::move(traceEvents);
+
+    std::ofstream traceFile(tracePath);
+    if (!traceFile) {
+        logMessage("ERROR - failed to write trace file: " + tracePath.string(), logFile);
+        return false;
+    }
+    traceFile << output << "\n";
+    return true;
+}
+
+// Accumulate another stage measurement (peak live bytes is kept as the peak value)
+StageStats& StageStats::operator+=(const StageStats& other) {
+    calls += other.calls;
+    seconds += other.seconds;
+    allocations += other.allocations;
+    allocatedBytes += other.allocatedBytes;
+    peakLiveBytes = std::max(peakLiveBytes, other.peakLiveBytes);
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+        perfCounts[i] += other.perfCounts[i];
+    }
+    return *this;
+}
+
+StageScope::StageScope(StageContext& context, const char* name, const char* category)
+    : context_(context), name_(name), category_(category),
+    active_(context.tracer != nullptr || context.stages != nullptr || context.peakRssBytes != nullptr) {
+    if (active_) {
+        sampleRss();
+        if (context_.stages != nullptr && allocationStatsEnabled()) {
+            AllocationSnapshot snapshot = allocationSnapshot();
+            startAllocations_ = snapshot.allocations;
+            startAllocatedBytes_ = snapshot.allocatedBytes;
+            outerPeak_ = beginPeakWindow();
+        }
+        if (context_.stages != nullptr && context_.perfCounters != nullptr) {
+            startCounters_ = context_.perfCounters->read();
+        }
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+StageScope::~StageScope() {
+    finish();
+}
+
+// Sample the resident set size at a stage boundary and keep the peak
+void StageScope::sampleRss() {
+    if (context_.peakRssBytes != nullptr) {
+        *context_.peakRssBytes = std::max(*context_.peakRssBytes, readCurrentRss());
+    }
+}
+
+// End the stage before the scope ends
+void StageScope::finish() {
+    if (!active_) {
+        return;
+    }
+    active_ = false;
+
+    auto end = std::chrono::steady_clock::now();
+    sampleRss();
+
+    PerfCounterValues endCounters;
+    if (context_.stages != nullptr && context_.perfCounters != nullptr) {
+        endCounters = context_.perfCounters->read();
+    }
+
+    if (context_.tracer != nullptr) {
+        context_.tracer->addSpan(name_, category_, context_.fileName, start_, end);
+    }
+
+    if (context_.stages != nullptr) {
+        StageStats stats;
+        stats.calls = 1;
+        stats.seconds = std::chrono::duration<double>(end - start_).count();
+        if (allocationStatsEnabled()) {
+            AllocationSnapshot snapshot = allocationSnapshot();
+            stats.allocations = snapshot.allocations - startAllocations_;
+            stats.allocatedBytes = snapshot.allocatedBytes - startAllocatedBytes_;
+            stats.peakLiveBytes = endPeakWindow(outerPeak_);
+        }
+        if (context_.perfCounters != nullptr) {
+            for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+                stats.perfCounts[i] = endCounters.values[i] - startCounters_.values[i];
+            }
+        }
+        (*context_.stages)[name_] += stats;
+    }
+}
+
+// Function to record a finished tes3conv run on its own child process track
+void traceChildProcess(StageContext& context, const char* name, const ProcessResult& result) {
+    if (context.tracer != nullptr && result.started) {
+        context.tracer->addSpan(name, "tes3conv", context.fileName, result.startTime, result.endTime, result.processId);
+    }
+}
@@ -1,10 +1,12 @@
 #include <algorithm>
+#include <array>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <regex>
 #include <sstream>
 #include <string>
@@ -14,14 +16,766 @@
 #include <cctype>
 #include <cstdlib>
 
+#include "ab_binary_patch.h"
+#include "ab_cell_conflicts.h"
+#include "ab_content_probe.h"
 #include "ab_coord_processor.h"
+#include "ab_coverage_index.h"
 #include "ab_data_processor.h"
 #include "ab_database.h"
+#include "ab_edit_plan.h"
+#include "ab_event_log.h"
 #include "ab_file_processor.h"
+#include "ab_library.h"
 #include "ab_logger.h"
+#include "ab_manifest.h"
+#include "ab_memory.h"
 #include "ab_options.h"
+#include "ab_perf_counters.h"
+#include "ab_process.h"
+#include "ab_progress.h"
+#include "ab_record_cache.h"
+#include "ab_report.h"
+#include "ab_shard.h"
+#include "ab_trace.h"
 #include "ab_user_interaction.h"
 
+// Function to load a cell mapping table from a text file or from a .db file
+static bool loadMappingEntries(const std::filesystem::path& mappingPath, std::vector<CellMappingEntry>& entries, std::ofstream& logFile) {
+    if (!std::filesystem::exists(mappingPath)) {
+        logMessage("ERROR - cell mapping file '" + mappingPath.string() + "' not found!", logFile);
+        return false;
+    }
+
+    bool loaded = false;
+    if (mappingPath.extension() == ".db") {
+        Database mappingDb(mappingPath.string());
+        loaded = loadCellMappingTable(mappingDb, entries, logFile);
+    }
+    else {
+        loaded = loadCellMappingFile(mappingPath.string(), entries, logFile);
+    }
+    if (!loaded || entries.empty()) {
+        logMessage("ERROR - cell mapping file '" + mappingPath.string() + "' holds no valid cells!", logFile);
+        return false;
+    }
+    return true;
+}
+
+// Function to parse a --profile <name>=<spec> argument
+static bool parseProfileSpec(const std::string& argument, ConversionProfile& profile, std::ofstream& logFile) {
+    size_t separator = argument.find('=');
+    if (separator == std::string::npos || separator == 0) {
+        logMessage("ERROR - invalid profile '" + argument + "', expected <name>=<spec>", logFile);
+        return false;
+    }
+
+    profile.name = argument.substr(0, separator);
+    if (profile.name.find_first_of("/\\:") != std::string::npos || profile.name == "." || profile.name == "..") {
+        logMessage("ERROR - invalid profile name: " + profile.name, logFile);
+        return false;
+    }
+
+    // The direction comes first, an optional mapping table follows after the first colon
+    std::string spec = argument.substr(separator + 1);
+    std::string direction = spec.substr(0, spec.find(':'));
+    std::transform(direction.begin(), direction.end(), direction.begin(), ::tolower);
+    if (direction == "bm-to-ab" || direction == "1") {
+        profile.conversionType = 1;
+    }
+    else if (direction == "ab-to-bm" || direction == "2") {
+        profile.conversionType = 2;
+    }
+    else {
+        logMessage("ERROR - invalid profile direction '" + direction + "' (expected bm-to-ab or ab-to-bm)", logFile);
+        return false;
+    }
+
+    if (spec.size() > direction.size()) {
+        std::vector<CellMappingEntry> entries;
+        if (!loadMappingEntries(spec.substr(direction.size() + 1), entries, logFile)) {
+            return false;
+        }
+        CellMapping forward(std::move(entries));
+        profile.mapping = std::make_shared<const CellMapping>(profile.conversionType == 2 ? forward.inverted() : std::move(forward));
+    }
+    return true;
+}
+
+// Function to decode a plugin file with tes3conv and parse the resulting .JSON
+static bool decodePluginFile(const std::filesystem::path& pluginImportPath, const std::filesystem::path& jsonImportPath, ordered_json& inputData,
+    FileReport& fileReport, StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile) {
+    // Convert the input file to .JSON
+    ProcessResult decodeResult;
+    {
+        StageScope decodeStage(stageContext, "tes3conv decode", "pipeline");
+        decodeResult = runTes3conv(pluginImportPath, jsonImportPath);
+    }
+    fileReport.decode += decodeResult.usage;
+    traceChildProcess(stageContext, "tes3conv decode", decodeResult);
+
+    if (!decodeResult.started || decodeResult.exitCode != 0) {
+        fileReport.reason = "tes3conv decode failed";
+        logMessage("ERROR - converting to .JSON failed for file: " + pluginImportPath.string() + "\n", logFile);
+        return false;
+    }
+    if (!options.silentMode) {
+        logMessage("Conversion to .JSON successful: " + jsonImportPath.string(), logFile);
+    }
+
+    // Load the generated JSON file
+    StageScope parseStage(stageContext, "json parse", "pipeline");
+    std::ifstream inputFile(jsonImportPath, std::ios::binary);
+    if (!inputFile.is_open()) {
+        fileReport.reason = "failed to open .JSON";
+        logMessage("ERROR - failed to open JSON file: " + jsonImportPath.string() + "\n", logFile);
+        return false;
+    }
+
+    inputFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+    try {
+        inputFile >> inputData;
+
+        if (inputData.is_discarded()) {
+            fileReport.reason = "invalid .JSON";
+            logMessage("ERROR - parsed JSON is invalid or empty: " + jsonImportPath.string() + "\n", logFile);
+            return false;
+        }
+    }
+    catch (const std::exception& e) {
+        fileReport.reason = "invalid .JSON";
+        logMessage("ERROR - failed to parse JSON (" + jsonImportPath.string() + "): " + e.what() + "\n", logFile);
+        return false;
+    }
+
+    inputFile.close();
+    parseStage.finish();
+    fileReport.recordCount = inputData.size();
+    return true;
+}
+
+// Function to save the converted .JSON, back up the original file and encode the result in its place
+static bool encodePluginFile(const std::filesystem::path& pluginImportPath, const std::filesystem::path& jsonImportPath, const ordered_json& inputData,
+    std::filesystem::path& backupPath, FileReport& fileReport, StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile) {
+    // Save the modified data to .JSON file
+    auto newJsonName = std::format("TEMP_{}{}", pluginImportPath.stem().string(), ".json");
+    std::filesystem::path jsonExportPath = pluginImportPath.parent_path() / newJsonName;
+
+    StageScope serializeStage(stageContext, "json serialize", "pipeline");
+    if (!saveJsonToFile(jsonExportPath, inputData, options, logFile)) {
+        fileReport.reason = "failed to save .JSON";
+        logMessage("ERROR - failed to save modified data to .JSON file: " + jsonExportPath.string() + "\n", logFile);
+        return false;
+    }
+
+    serializeStage.finish();
+
+    // Create backup before modifying original file
+    StageScope backupStage(stageContext, "backup", "pipeline");
+    if (!createBackup(pluginImportPath, backupPath, options, logFile)) {
+        fileReport.reason = "backup failed";
+        std::filesystem::remove(jsonImportPath);
+        if (!options.silentMode) {
+            logMessage("Temporary .JSON file deleted: " + jsonImportPath.string(), logFile);
+        }
+
+        return false;
+    }
+
+    backupStage.finish();
+
+    // Save converted file with original name
+    ProcessResult encodeResult;
+    StageScope encodeStage(stageContext, "tes3conv encode", "pipeline");
+    bool encoded = convertJsonToEsp(jsonExportPath, pluginImportPath, encodeResult, options, logFile);
+    encodeStage.finish();
+    fileReport.encode += encodeResult.usage;
+    traceChildProcess(stageContext, "tes3conv encode", encodeResult);
+
+    if (!encoded) {
+        fileReport.reason = "tes3conv encode failed";
+        logMessage("ERROR - failed to convert .JSON back to .ESP|ESM: " + pluginImportPath.string() + "\n", logFile);
+        return false;
+    }
+
+    // Clean up temporary .JSON files
+    StageScope cleanupStage(stageContext, "cleanup", "pipeline");
+    std::filesystem::remove(jsonImportPath);
+    std::filesystem::remove(jsonExportPath);
+    if (!options.silentMode) {
+        logMessage("Temporary .JSON files deleted: " + jsonImportPath.string() + "\n" +
+                   "                          and: " + jsonExportPath.string(), logFile);
+    }
+
+    return true;
+}
+
+// Function to save a binary patch from the original to the converted file as <converted file>.abpatch;
+// the patch is only saved once it is verified to restore the original file
+static bool savePluginPatch(const std::filesystem::path& originalPath, const std::filesystem::path& convertedPath, int conversionType,
+    StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile) {
+    StageScope patchStage(stageContext, "binary patch", "pipeline");
+    std::string original, converted;
+    if (!readFileBytes(originalPath, original) || !readFileBytes(convertedPath, converted)) {
+        logMessage("ERROR - failed to read the files for the binary patch: " + convertedPath.string(), logFile);
+        return false;
+    }
+
+    BinaryPatch patch = buildBinaryPatch(original, converted);
+    patch.conversionType = conversionType;
+
+    std::string restored, error;
+    if (!applyBinaryPatch(converted, invertBinaryPatch(patch), restored, error)) {
+        logMessage("ERROR - binary patch does not restore the original file " + originalPath.string() + ": " + error, logFile);
+        return false;
+    }
+
+    std::filesystem::path patchPath = convertedPath;
+    patchPath += ".abpatch";
+    if (!saveBinaryPatch(patchPath, patch, logFile)) {
+        return false;
+    }
+
+    if (!options.silentMode) {
+        logMessage("Binary patch saved as: " + patchPath.string() + " (" + std::to_string(patch.runs.size()) + " runs, " +
+                   std::to_string(binaryPatchPayload(patch)) + " of " + std::to_string(original.size()) + " bytes)", logFile);
+    }
+    return true;
+}
+
+// Function to scan a plugin before it is decoded; returns true if it was skipped because nothing in it can be converted
+static bool skipIrrelevantPlugin(const std::filesystem::path& pluginImportPath, const std::vector<const CellMapping*>& mappings,
+    FileReport& fileReport, StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile) {
+    ContentProbe probe;
+    {
+        StageScope probeStage(stageContext, "content probe", "pipeline");
+        std::string data;
+        if (!readFileBytes(pluginImportPath, data)) {
+            return false;
+        }
+        probe = probePluginContent(data, mappings);
+    }
+
+    if (probe.result != ProbeResult::NothingToConvert) {
+        if (!options.silentMode && probe.result == ProbeResult::Relevant) {
+            logMessage("Content probe: " + probe.match, logFile);
+        }
+        return false;
+    }
+
+    fileReport.status = "skipped";
+    fileReport.reason = "nothing to convert";
+    logMessage("Nothing to convert in file: " + pluginImportPath.string() + " - conversion skipped...\n", logFile);
+    return true;
+}
+
+// Function to convert a single plugin file and record its outcome in the file report
+static void processPluginFile(const std::filesystem::path& pluginImportPath, const CoordinateIndex& index, RecordCache* recordCache,
+    std::vector<std::string>& updatedScriptIDs, FileReport& fileReport, StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile) {
+    // Define the output file path
+    std::filesystem::path jsonImportPath = pluginImportPath.parent_path() / (pluginImportPath.stem().string() + ".json");
+
+    // Convert the input file to .JSON and load it
+    ordered_json inputData;
+    if (!decodePluginFile(pluginImportPath, jsonImportPath, inputData, fileReport, stageContext, options, logFile)) {
+        return;
+    }
+
+    // Keep the decoded data and the input hash for the edit plan
+    ordered_json originalData;
+    std::string inputHash;
+    if (options.savePlan) {
+        originalData = inputData;
+        inputHash = hashFileContents(pluginImportPath);
+    }
+
+    // Convert the plugin data (only the records that changed since the cached version with --incremental)
+    ConversionOutcome outcome = recordCache
+        ? convertPluginIncremental(inputData, pluginImportPath, index.mapping(options.conversionType), *recordCache, fileReport.recordCache,
+            updatedScriptIDs, stageContext, options, logFile)
+        : convertPluginData(inputData, pluginImportPath, index, updatedScriptIDs, stageContext, options, logFile);
+    if (outcome != ConversionOutcome::Converted) {
+        fileReport.reason = conversionOutcomeReason(outcome);
+        if (outcome == ConversionOutcome::NoHeaderDescription) {
+            logMessage("ERROR - could not find or modify header description\n", logFile);
+            return;
+        }
+
+        std::filesystem::remove(jsonImportPath);
+        fileReport.status = "skipped";
+        if (outcome == ConversionOutcome::AlreadyConverted) {
+            logMessage("ERROR - file " + pluginImportPath.string() + " was already converted - conversion skipped...", logFile);
+        }
+        else if (outcome == ConversionOutcome::MissingMasters) {
+            logMessage("ERROR - required Parent Masters not found for file: " + pluginImportPath.string() + " - conversion skipped...", logFile);
+        }
+        else {
+            logMessage("No replacements found for file: " + pluginImportPath.string() + " - conversion skipped...", logFile);
+        }
+        if (options.silentMode) {
+            logMessage("", logFile);
+        }
+        else {
+            logMessage("Temporary .JSON file deleted: " + jsonImportPath.string() + "\n", logFile);
+        }
+
+        return;
+    }
+
+    // Save, back up and encode the converted file
+    std::filesystem::path backupPath;
+    if (!encodePluginFile(pluginImportPath, jsonImportPath, inputData, backupPath, fileReport, stageContext, options, logFile)) {
+        return;
+    }
+
+    // Save the edit plan next to the converted file
+    if (options.savePlan) {
+        EditPlan plan = buildEditPlan(originalData, inputData);
+        plan.conversionType = options.conversionType;
+        plan.inputHash = inputHash;
+        plan.outputHash = hashFileContents(pluginImportPath);
+
+        std::filesystem::path planPath = pluginImportPath;
+        planPath += ".plan.json";
+        if (saveEditPlan(planPath, plan, logFile) && !options.silentMode) {
+            logMessage("Edit plan saved as: " + planPath.string() + " (" + std::to_string(plan.operations.size()) + " edits)", logFile);
+        }
+    }
+
+    // Save the binary patch in place of the backup
+    if (options.savePatch && savePluginPatch(backupPath, pluginImportPath, options.conversionType, stageContext, options, logFile)) {
+        std::error_code removeError;
+        std::filesystem::remove(backupPath, removeError);
+        if (!removeError && !options.silentMode) {
+            logMessage("Backup replaced by the binary patch: " + backupPath.string(), logFile);
+        }
+    }
+
+    fileReport.status = "converted";
+}
+
+// Function to apply a binary patch to a single plugin file, verified by the hash of the file it was made for
+static void processPluginPatch(const std::filesystem::path& pluginImportPath, const BinaryPatch& patch, FileReport& fileReport,
+    StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile) {
+    std::string source;
+    if (!readFileBytes(pluginImportPath, source)) {
+        fileReport.reason = "failed to read file";
+        logMessage("ERROR - failed to read file: " + pluginImportPath.string() + "\n", logFile);
+        return;
+    }
+
+    // Rebuild the file in memory
+    std::string target, error;
+    {
+        StageScope applyStage(stageContext, "apply binary patch", "pipeline");
+        if (!applyBinaryPatch(source, patch, target, error)) {
+            fileReport.status = "skipped";
+            fileReport.reason = "binary patch does not match";
+            logMessage("Binary patch was not made for file: " + pluginImportPath.string() + " (" + error + ") - skipped...", logFile);
+            return;
+        }
+    }
+
+    // Create backup before modifying original file
+    std::filesystem::path backupPath;
+    {
+        StageScope backupStage(stageContext, "backup", "pipeline");
+        if (!createBackup(pluginImportPath, backupPath, options, logFile)) {
+            fileReport.reason = "backup failed";
+            return;
+        }
+    }
+
+    StageScope writeStage(stageContext, "write file", "pipeline");
+    if (!writeFileBytes(pluginImportPath, target)) {
+        fileReport.reason = "failed to write file";
+        logMessage("ERROR - failed to write patched file: " + pluginImportPath.string() + "\n", logFile);
+        return;
+    }
+    writeStage.finish();
+
+    logMessage("Binary patch applied: " + pluginImportPath.string() + " (" + std::to_string(patch.runs.size()) + " runs)", logFile);
+    if (options.silentMode) {
+        logMessage("", logFile);
+    }
+
+    fileReport.status = "converted";
+}
+
+// Function to replay an edit plan on a single plugin file, verified by the hash of the file it was made for
+static void processPluginPlan(const std::filesystem::path& pluginImportPath, const EditPlan& plan, FileReport& fileReport,
+    StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile) {
+    if (!plan.inputHash.empty() && hashFileContents(pluginImportPath) != plan.inputHash) {
+        fileReport.status = "skipped";
+        fileReport.reason = "edit plan does not match";
+        logMessage("Edit plan was not made for file: " + pluginImportPath.string() + " - skipped...", logFile);
+        return;
+    }
+
+    // Define the output file path
+    std::filesystem::path jsonImportPath = pluginImportPath.parent_path() / (pluginImportPath.stem().string() + ".json");
+
+    // Convert the input file to .JSON and load it
+    ordered_json inputData;
+    if (!decodePluginFile(pluginImportPath, jsonImportPath, inputData, fileReport, stageContext, options, logFile)) {
+        return;
+    }
+
+    // Apply the edits
+    std::string error;
+    {
+        StageScope applyStage(stageContext, "apply edit plan", "pipeline");
+        if (!applyEditPlan(inputData, plan, error)) {
+            fileReport.reason = "edit plan does not apply";
+            std::filesystem::remove(jsonImportPath);
+            logMessage("ERROR - edit plan does not apply to file " + pluginImportPath.string() + ": " + error + "\n", logFile);
+            return;
+        }
+    }
+    if (!options.silentMode) {
+        logMessage("Edit plan applied: " + std::to_string(plan.operations.size()) + " edits", logFile);
+    }
+
+    // Save, back up and encode the result
+    std::filesystem::path backupPath;
+    if (!encodePluginFile(pluginImportPath, jsonImportPath, inputData, backupPath, fileReport, stageContext, options, logFile)) {
+        return;
+    }
+
+    if (!plan.outputHash.empty() && hashFileContents(pluginImportPath) != plan.outputHash) {
+        logMessage("WARNING - result differs from the file the edit plan was saved with: " + pluginImportPath.string(), logFile);
+    }
+
+    fileReport.status = "converted";
+}
+
+// Function to convert a single plugin file for several profiles from one decode, writing each target to its profile folder
+static void processPluginProfiles(const std::filesystem::path& pluginImportPath, const CoordinateIndex& index,
+    const std::vector<ConversionProfile>& profiles, FileReport& fileReport, StageContext& stageContext,
+    const ProgramOptions& options, std::ofstream& logFile) {
+    // Define the output file path
+    std::filesystem::path jsonImportPath = pluginImportPath.parent_path() / (pluginImportPath.stem().string() + ".json");
+
+    // Convert the input file to .JSON and load it once for all profiles
+    ordered_json inputData;
+    if (!decodePluginFile(pluginImportPath, jsonImportPath, inputData, fileReport, stageContext, options, logFile)) {
+        return;
+    }
+
+    std::vector<ProfileOutput> outputs = convertPluginProfiles(inputData, pluginImportPath, index, profiles, stageContext, options, logFile);
+
+    int convertedCount = 0;
+    for (size_t p = 0; p < profiles.size(); ++p) {
+        const ConversionProfile& profile = profiles[p];
+        ProfileOutput& output = outputs[p];
+
+        if (output.outcome != ConversionOutcome::Converted) {
+            fileReport.profiles.emplace_back(profile.name, conversionOutcomeReason(output.outcome));
+            logMessage("Profile " + profile.name + ": " + conversionOutcomeReason(output.outcome) + " - target skipped for file: " +
+                       pluginImportPath.string(), logFile);
+            continue;
+        }
+
+        // Save the profile output to .JSON; the changed records are swapped in and back out around the write
+        std::filesystem::path targetDir = pluginImportPath.parent_path() / profile.name;
+        std::filesystem::path jsonExportPath = targetDir / std::format("TEMP_{}{}", pluginImportPath.stem().string(), ".json");
+        std::filesystem::path targetPath = targetDir / pluginImportPath.filename();
+        std::filesystem::create_directories(targetDir);
+
+        StageScope serializeStage(stageContext, "json serialize", "pipeline");
+        swapProfileRecords(inputData, output);
+        bool saved = saveJsonToFile(jsonExportPath, inputData, options, logFile);
+        swapProfileRecords(inputData, output);
+        serializeStage.finish();
+
+        if (!saved) {
+            fileReport.profiles.emplace_back(profile.name, "failed to save .JSON");
+            logMessage("ERROR - failed to save modified data to .JSON file: " + jsonExportPath.string() + "\n", logFile);
+            continue;
+        }
+
+        // Encode the target next to the original file
+        ProcessResult encodeResult;
+        StageScope encodeStage(stageContext, "tes3conv encode", "pipeline");
+        bool encoded = convertJsonToEsp(jsonExportPath, targetPath, encodeResult, options, logFile);
+        encodeStage.finish();
+        fileReport.encode += encodeResult.usage;
+        traceChildProcess(stageContext, "tes3conv encode", encodeResult);
+        std::filesystem::remove(jsonExportPath);
+
+        if (!encoded) {
+            fileReport.profiles.emplace_back(profile.name, "tes3conv encode failed");
+            logMessage("ERROR - failed to convert .JSON back to .ESP|ESM: " + targetPath.string() + "\n", logFile);
+            continue;
+        }
+
+        // Save the binary patch from the original to the target
+        if (options.savePatch) {
+            savePluginPatch(pluginImportPath, targetPath, profile.conversionType, stageContext, options, logFile);
+        }
+
+        // Only the targets that were written claim their moved cells
+        if (stageContext.touchedCells) {
+            stageContext.touchedCells->insert(stageContext.touchedCells->end(), output.touchedCells.begin(), output.touchedCells.end());
+        }
+
+        fileReport.profiles.emplace_back(profile.name, "converted");
+        ++convertedCount;
+    }
+
+    // Clean up the decoded .JSON file
+    std::filesystem::remove(jsonImportPath);
+    if (!options.silentMode) {
+        logMessage("Temporary .JSON file deleted: " + jsonImportPath.string() + "\n", logFile);
+    }
+
+    if (convertedCount > 0) {
+        fileReport.status = "converted";
+    }
+    else {
+        fileReport.status = "skipped";
+        fileReport.reason = "no profile converted";
+    }
+}
+
+// Function to add the cells a single plugin file touches to the coverage index; unchanged files are not read and
+// content that is already indexed is not decoded
+static void processPluginIndex(const std::filesystem::path& pluginImportPath, CoverageIndex& coverageIndex, FileReport& fileReport,
+    StageContext& stageContext, const ProgramOptions& options, std::ofstream& logFile) {
+    std::error_code error;
+    std::uint64_t size = std::filesystem::file_size(pluginImportPath, error);
+    std::int64_t modified = error ? 0 : static_cast<std::int64_t>(std::filesystem::last_write_time(pluginImportPath, error).time_since_epoch().count());
+    if (error) {
+        fileReport.reason = "failed to read file";
+        logMessage("ERROR - failed to read file: " + pluginImportPath.string() + "\n", logFile);
+        return;
+    }
+
+    if (coverageIndex.isCurrent(pluginImportPath, size, modified)) {
+        fileReport.status = "skipped";
+        fileReport.reason = "unchanged";
+        if (!options.silentMode) {
+            logMessage("Coverage index up to date for file: " + pluginImportPath.string(), logFile);
+        }
+        return;
+    }
+
+    std::string contentHash;
+    {
+        StageScope hashStage(stageContext, "hash", "pipeline");
+        contentHash = hashFileContents(pluginImportPath);
+    }
+    if (coverageIndex.linkKnownContent(pluginImportPath, size, modified, contentHash)) {
+        fileReport.status = "indexed";
+        fileReport.reason = "known content";
+        if (!options.silentMode) {
+            logMessage("Coverage index: same content as an indexed plugin, file linked: " + pluginImportPath.string(), logFile);
+        }
+        return;
+    }
+
+    // Define the output file path
+    std::filesystem::path jsonImportPath = pluginImportPath.parent_path() / (pluginImportPath.stem().string() + ".json");
+
+    // Convert the input file to .JSON and load it
+    ordered_json inputData;
+    if (!decodePluginFile(pluginImportPath, jsonImportPath, inputData, fileReport, stageContext, options, logFile)) {
+        return;
+    }
+    std::filesystem::remove(jsonImportPath);
+
+    PluginCoverage coverage;
+    {
+        StageScope coverageStage(stageContext, "coverage", "pipeline");
+        coverage = collectPluginCoverage(inputData);
+    }
+
+    StageScope storeStage(stageContext, "index store", "pipeline");
+    if (!coverageIndex.store(pluginImportPath, size, modified, contentHash, coverage)) {
+        fileReport.reason = "failed to update the coverage index";
+        logMessage("ERROR - failed to update the coverage index for file: " + pluginImportPath.string() + "\n", logFile);
+        return;
+    }
+    storeStage.finish();
+
+    logMessage(std::format("Coverage indexed: {} cells, {} landscapes, {} path grids, {} script cells ({})", coverage.cells.size(),
+        coverage.landscapes.size(), coverage.pathGrids.size(), coverage.scriptCells.size(), coverage.status), logFile);
+    if (options.silentMode) {
+        logMessage("", logFile);
+    }
+
+    fileReport.status = "indexed";
+}
+
+// Function to answer a coverage query from the index and log the plugins found
+static void runCoverageQuery(const CoordinateIndex& index, const ProgramOptions& options, std::ofstream& logFile) {
+    if (!std::filesystem::exists(COVERAGE_INDEX_FILE)) {
+        logErrorAndExit("ERROR - coverage index '" + COVERAGE_INDEX_FILE + "' not found! Build it with --index first.\n", logFile);
+    }
+
+    const CellMapping& mapping = index.mapping(options.conversionType == 2 ? 2 : 1);
+    std::vector<std::pair<int, int>> cells;
+    if (!parseCoverageQuery(options.indexQuery, mapping, cells, logFile)) {
+        logErrorAndExit("ERROR - invalid coverage query!\n", logFile);
+    }
+
+    CoverageIndex coverageIndex(COVERAGE_INDEX_FILE);
+    auto queryStart = std::chrono::steady_clock::now();
+    std::vector<CoverageMatch> matches = coverageIndex.query(cells, mapping);
+    auto queryEnd = std::chrono::steady_clock::now();
+
+    size_t wouldModify = std::count_if(matches.begin(), matches.end(), [](const CoverageMatch& match) { return match.wouldModify(); });
+    logMessage(std::format("\nCoverage query: {} cells, {} of {} indexed plugins touch them, {} would be modified ({:.2f} ms)",
+        cells.size(), matches.size(), coverageIndex.pluginCount(), wouldModify,
+        std::chrono::duration<double, std::milli>(queryEnd - queryStart).count()), logFile);
+
+    for (const auto& match : matches) {
+        logMessage(std::format("- {}: {} cells, {} landscapes, {} path grids, {} script cells, {} mapped - {}", match.path, match.cells,
+            match.landscapes, match.pathGrids, match.scriptCells, match.mappedCells,
+            match.wouldModify() ? std::string("would be modified") : (match.status == "convertible" ? std::string("no mapped cells") : match.status)), logFile);
+    }
+}
+
+// Function to report what converting a single plugin file would change; nothing is saved, backed up or encoded
+static void processPluginDryRun(const std::filesystem::path& pluginImportPath, const CoordinateIndex& index,
+    const std::vector<ConversionProfile>& profiles, FileReport& fileReport, StageContext& stageContext,
+    const ProgramOptions& options, std::ofstream& logFile) {
+    // Decode into the temporary directory, a dry run writes nothing next to the plugins (the process id keeps
+    // concurrent shard workers apart)
+    std::filesystem::path jsonImportPath = std::filesystem::temp_directory_path() /
+        std::format("tes3ab_{}_{}.json", currentProcessId(), pluginImportPath.stem().string());
+
+    // Convert the input file to .JSON and load it
+    ordered_json inputData;
+    bool decoded = decodePluginFile(pluginImportPath, jsonImportPath, inputData, fileReport, stageContext, options, logFile);
+    std::error_code removeError;
+    std::filesystem::remove(jsonImportPath, removeError);
+    if (!decoded) {
+        return;
+    }
+
+    // Only the records the handlers can touch are copied and converted
+    std::vector<ProfileOutput> outputs = convertPluginProfiles(inputData, pluginImportPath, index, profiles, stageContext, options, logFile);
+
+    int convertedCount = 0;
+    for (size_t p = 0; p < profiles.size(); ++p) {
+        const ConversionProfile& profile = profiles[p];
+        const ProfileOutput& output = outputs[p];
+        std::string label = profiles.size() > 1 ? "Dry run (" + profile.name + "): " : "Dry run: ";
+
+        if (output.outcome != ConversionOutcome::Converted) {
+            if (profiles.size() > 1) {
+                fileReport.profiles.emplace_back(profile.name, conversionOutcomeReason(output.outcome));
+            }
+            else {
+                fileReport.reason = conversionOutcomeReason(output.outcome);
+            }
+            logMessage(label + conversionOutcomeReason(output.outcome) + " - file would be skipped: " + pluginImportPath.string(), logFile);
+            continue;
+        }
+
+        ChangeSummary changes;
+        for (const auto& [recordIndex, record] : output.records) {
+            addRecordChanges(changes, inputData[recordIndex], record);
+        }
+        fileReport.changes += changes;
+        if (stageContext.touchedCells) {
+            stageContext.touchedCells->insert(stageContext.touchedCells->end(), output.touchedCells.begin(), output.touchedCells.end());
+        }
+        if (profiles.size() > 1) {
+            fileReport.profiles.emplace_back(profile.name, "converted");
+        }
+        logMessage(label + "file would be converted (" + formatChangeSummary(changes) + ")", logFile);
+        ++convertedCount;
+    }
+
+    if (options.silentMode) {
+        logMessage("", logFile);
+    }
+
+    if (convertedCount > 0) {
+        fileReport.status = "converted";
+    }
+    else {
+        fileReport.status = "skipped";
+        if (profiles.size() > 1) {
+            fileReport.reason = "no profile converted";
+        }
+    }
+}
+
+// Function to add the stage timings and the outcome of a processed file to the event log
+static void recordFileEvents(EventLog& events, const FileReport& fileReport) {
+    for (const auto& [name, stats] : fileReport.stages) {
+        ordered_json stage;
+        stage["name"] = name;
+        stage["calls"] = stats.calls;
+        stage["seconds"] = stats.seconds;
+        events.emit("stage", std::move(stage));
+    }
+
+    ordered_json finished;
+    finished["status"] = fileReport.status;
+    if (!fileReport.reason.empty()) {
+        finished["reason"] = fileReport.reason;
+    }
+    finished["seconds"] = fileReport.totalSeconds;
+    finished["tes3conv_seconds"] = fileReport.decode.wallSeconds + fileReport.encode.wallSeconds;
+    finished["records"] = fileReport.recordCount;
+    finished["input_bytes"] = fileReport.inputBytes;
+    events.emit("file_finished", std::move(finished));
+}
+
+// Function to queue the targets (or the manifest) as the jobs of a sharded batch
+static void queueShardJobs(ProgramOptions& options, std::ofstream& logFile) {
+    if (!initShardJobDirectory(options.shardInitDir, logFile)) {
+        logErrorAndExit("ERROR - failed to set up the job directory!\n", logFile);
+    }
+
+    // Jobs carry their conversion, so the workers need not be told
+    std::unique_ptr<ManifestReader> manifest;
+    std::vector<std::filesystem::path> inputPaths;
+    if (!options.manifestFile.empty()) {
+        try {
+            manifest = std::make_unique<ManifestReader>(options.manifestFile);
+        }
+        catch (const std::exception& e) {
+            logErrorAndExit("ERROR - " + std::string(e.what()) + "\n", logFile);
+        }
+    }
+    else {
+        if (options.conversionType == 0) {
+            options.conversionType = getUserConversionChoice(logFile);
+        }
+        inputPaths = getInputFilePaths(options, logFile);
+    }
+
+    ManifestEntry entry;
+    size_t jobCount = 0;
+    while (manifest ? manifest->next(entry, logFile) : jobCount < inputPaths.size()) {
+        if (!manifest) {
+            entry = ManifestEntry();
+            entry.path = inputPaths[jobCount];
+        }
+        if (entry.conversionType == 0) {
+            entry.conversionType = options.conversionType;
+        }
+
+        // Workers may run in other directories or on other hosts sharing the files
+        std::error_code pathError;
+        std::filesystem::path absolutePath = std::filesystem::absolute(entry.path, pathError);
+        if (!pathError) {
+            entry.path = absolutePath.lexically_normal();
+        }
+        if (!addShardJob(options.shardInitDir, ++jobCount, entry, logFile)) {
+            logErrorAndExit("ERROR - failed to queue the jobs!\n", logFile);
+        }
+    }
+
+    logMessage("\nQueued " + std::to_string(jobCount) + " jobs in " + options.shardInitDir.string(), logFile);
+}
+
 // Main function
 int main(int argc, char* argv[]) {
     // Parse command line arguments
@@ -41,10 +795,60 @@ int main(int argc, char* argv[]) {
 
     // Clear log file
     logClear();
+
+    // Set the log level and categories (the handler details are only logged without -s)
+    LogLevel logLevel = options.silentMode ? LogLevel::Warn : LogLevel::Trace;
+    if (!options.logLevel.empty() && !parseLogLevel(options.logLevel, logLevel)) {
+        logErrorAndExit("ERROR - unknown log level: " + options.logLevel + "\n", logFile);
+    }
+    unsigned logCategories = LOG_ALL;
+    if (!options.logCategories.empty() && !parseLogCategories(options.logCategories, logCategories)) {
+        logErrorAndExit("ERROR - unknown log category in: " + options.logCategories + "\n", logFile);
+    }
+    setLogLevel(logLevel);
+    setLogCategories(logCategories);
+
+    // Open the structured event log; the handlers and the logger report to it while it is set
+    std::unique_ptr<EventLog> eventLog;
+    if (!options.eventFile.empty()) {
+        try {
+            eventLog = std::make_unique<EventLog>(options.eventFile);
+        }
+        catch (const std::exception& e) {
+            logErrorAndExit("ERROR - " + std::string(e.what()) + "\n", logFile);
+        }
+        setEventLog(eventLog.get());
+    }
     if (!options.silentMode) {
         logMessage("Log file cleared...", logFile);
     }
 
+    // Merge the results of a sharded batch; no plugin is read
+    if (!options.shardFinalizeDir.empty()) {
+        const std::filesystem::path reportPath = options.reportFile.empty() ? options.shardFinalizeDir / "report.json" : options.reportFile;
+        return mergeShardResults(options.shardFinalizeDir, reportPath, logFile) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // A worker takes its plugins from the job directory, and the jobs are queued by a separate run
+    if (!options.shardDir.empty() && (!options.manifestFile.empty() || !options.inputFiles.empty() || !options.shardInitDir.empty())) {
+        logErrorAndExit("ERROR - --shard cannot be combined with targets, --manifest or --shard-init!\n", logFile);
+    }
+    if (!options.shardInitDir.empty()) {
+        queueShardJobs(options, logFile);
+        return EXIT_SUCCESS;
+    }
+
+    // Parse the claim timeout of a worker
+    std::chrono::seconds claimTimeout = DEFAULT_CLAIM_TIMEOUT;
+    if (!options.claimTimeout.empty()) {
+        char* end = nullptr;
+        const long seconds = std::strtol(options.claimTimeout.c_str(), &end, 10);
+        if (end == options.claimTimeout.c_str() || *end != '\0' || seconds <= 0) {
+            logErrorAndExit("ERROR - invalid claim timeout: " + options.claimTimeout + "\n", logFile);
+        }
+        claimTimeout = std::chrono::seconds(seconds);
+    }
+
     // Check if the database file exists
     if (!std::filesystem::exists("tes3_ab_cell_x-y_data.db")) {
         logErrorAndExit("ERROR - database file 'tes3_ab_cell_x-y_data.db' not found!\n", logFile);
@@ -63,242 +867,531 @@ int main(int argc, char* argv[]) {
         logErrorAndExit("ERROR - custom grid coordinates file 'tes3_ab_custom_cell_x-y_data.txt' not found!\n", logFile);
     }
 
-    // Open the custom grid coordinates
+    // Open the custom grid coordinates; a dry run reads the compiled cache but never writes it
     std::unordered_set<std::pair<int, int>, PairHash> customCoordinates;
-    loadCustomGridCoordinates(customDBFilePath.string(), customCoordinates, logFile);
+    loadCustomGridCoordinates(customDBFilePath.string(), customCoordinates, !options.dryRun, logFile);
     if (!options.silentMode) {
         logMessage("Custom grid coordinates loaded successfully...", logFile);
     }
 
-    // Check if the converter executable exists
-    if (!std::filesystem::exists(TES3CONV_COMMAND)) {
+    // The coordinate index owns the database and custom grid coordinates from here on
+    CoordinateIndex index(std::move(db), std::move(customCoordinates));
+
+    // Load the cell mapping table if one was given
+    if (!options.mappingFile.empty()) {
+        std::vector<CellMappingEntry> entries;
+        if (!loadMappingEntries(options.mappingFile, entries, logFile)) {
+            logErrorAndExit("ERROR - failed to load the cell mapping table!\n", logFile);
+        }
+
+        index.useMappingTable(std::move(entries));
+        if (!options.silentMode) {
+            logMessage("Cell mapping table loaded: " + std::to_string(index.mapping(1).size()) + " cells...", logFile);
+        }
+    }
+
+    // Answer a coverage query from the index; no plugin is read
+    if (!options.indexQuery.empty()) {
+        runCoverageQuery(index, options, logFile);
+        return EXIT_SUCCESS;
+    }
+
+    // Parse the conversion profiles
+    std::vector<ConversionProfile> profiles;
+    for (const auto& spec : options.profileSpecs) {
+        ConversionProfile profile;
+        if (!parseProfileSpec(spec, profile, logFile)) {
+            logErrorAndExit("ERROR - failed to set up the conversion profiles!\n", logFile);
+        }
+        for (const auto& other : profiles) {
+            if (other.name == profile.name) {
+                logErrorAndExit("ERROR - duplicate profile name: " + profile.name + "\n", logFile);
+            }
+        }
+        profiles.push_back(std::move(profile));
+    }
+
+    // Load the edit plan to replay
+    std::unique_ptr<EditPlan> editPlan;
+    if (!options.applyPlanFile.empty() || !options.revertPlanFile.empty()) {
+        if (!options.applyPlanFile.empty() && !options.revertPlanFile.empty()) {
+            logErrorAndExit("ERROR - --apply-plan and --revert-plan cannot be combined!\n", logFile);
+        }
+        if (!profiles.empty()) {
+            logErrorAndExit("ERROR - edit plans cannot be combined with --profile!\n", logFile);
+        }
+
+        editPlan = std::make_unique<EditPlan>();
+        const std::filesystem::path& planPath = options.applyPlanFile.empty() ? options.revertPlanFile : options.applyPlanFile;
+        if (!loadEditPlan(planPath, *editPlan, logFile)) {
+            logErrorAndExit("ERROR - failed to load the edit plan!\n", logFile);
+        }
+        if (!options.revertPlanFile.empty()) {
+            *editPlan = invertEditPlan(*editPlan);
+        }
+        options.conversionType = editPlan->conversionType;
+        options.savePlan = false;
+    }
+
+    // Indexing only reads plugins, so it cannot be combined with the other modes
+    std::unique_ptr<CoverageIndex> coverageIndex;
+    if (options.buildIndex) {
+        if (options.dryRun || !profiles.empty() || !options.applyPlanFile.empty() || !options.revertPlanFile.empty() ||
+            !options.applyPatchFile.empty() || !options.revertPatchFile.empty()) {
+            logErrorAndExit("ERROR - --index cannot be combined with other modes!\n", logFile);
+        }
+        try {
+            coverageIndex = std::make_unique<CoverageIndex>(COVERAGE_INDEX_FILE);
+        }
+        catch (const std::exception& e) {
+            logErrorAndExit("ERROR - " + std::string(e.what()) + "\n", logFile);
+        }
+        options.savePlan = false;
+        options.savePatch = false;
+        if (options.conversionType == 0) {
+            options.conversionType = 1;
+        }
+    }
+
+    // A dry run only analyses, so it cannot replay plans or patches and saves neither
+    if (options.dryRun) {
+        if (!options.applyPlanFile.empty() || !options.revertPlanFile.empty() ||
+            !options.applyPatchFile.empty() || !options.revertPatchFile.empty()) {
+            logErrorAndExit("ERROR - --dry-run cannot be combined with edit plans or binary patches!\n", logFile);
+        }
+        options.savePlan = false;
+        options.savePatch = false;
+    }
+
+    // Load the binary patch to apply
+    std::unique_ptr<BinaryPatch> binaryPatch;
+    if (!options.applyPatchFile.empty() || !options.revertPatchFile.empty()) {
+        if (!options.applyPatchFile.empty() && !options.revertPatchFile.empty()) {
+            logErrorAndExit("ERROR - --apply-patch and --revert-patch cannot be combined!\n", logFile);
+        }
+        if (!profiles.empty() || editPlan) {
+            logErrorAndExit("ERROR - binary patches cannot be combined with --profile or edit plans!\n", logFile);
+        }
+
+        binaryPatch = std::make_unique<BinaryPatch>();
+        const std::filesystem::path& patchPath = options.applyPatchFile.empty() ? options.revertPatchFile : options.applyPatchFile;
+        if (!loadBinaryPatch(patchPath, *binaryPatch, logFile)) {
+            logErrorAndExit("ERROR - failed to load the binary patch!\n", logFile);
+        }
+        if (!options.revertPatchFile.empty()) {
+            *binaryPatch = invertBinaryPatch(*binaryPatch);
+        }
+        options.conversionType = binaryPatch->conversionType;
+        options.savePlan = false;
+        options.savePatch = false;
+    }
+
+    // The record cache only serves plain conversions
+    if (options.incremental && (options.dryRun || !profiles.empty() || editPlan || binaryPatch || coverageIndex)) {
+        logErrorAndExit("ERROR - --incremental cannot be combined with other modes!\n", logFile);
+    }
+
+    // Check if the converter executable exists (binary patches are applied without it)
+    if (!binaryPatch && !std::filesystem::exists(TES3CONV_COMMAND)) {
         logErrorAndExit("ERROR - tes3conv not found! Please download the latest version from\n"
                         "github.com/Greatness7/tes3conv/releases and place it in the same directory\n"
                         "with this program.\n", logFile);
     }
 
     if (!options.silentMode) {
-        logMessage("tes3conv found...\n"
+        logMessage(std::string(binaryPatch ? "" : "tes3conv found...\n") +
                    "Initialisation complete...\n"
                    "(\\/)Oo(\\/)", logFile);
     }
 
-    // Get the conversion choice
-    if (options.conversionType == 0) {
+    // Get the conversion choice (profiles, edit plans and binary patches carry their own)
+    if (binaryPatch) {
+        if (!options.silentMode) {
+            logMessage("\nBinary patch loaded: " + std::to_string(binaryPatch->runs.size()) + " runs", logFile);
+        }
+    }
+    else if (editPlan) {
+        if (!options.silentMode) {
+            logMessage("\nEdit plan loaded: " + std::to_string(editPlan->operations.size()) + " edits", logFile);
+        }
+    }
+    else if (!profiles.empty()) {
+        if (!options.silentMode) {
+            logMessage("\nConversion profiles set from arguments: " + std::to_string(profiles.size()), logFile);
+        }
+    }
+    else if (options.conversionType == 0 && !options.manifestFile.empty()) {
+        if (!options.silentMode) {
+            logMessage("\nConversion type set per file from the manifest", logFile);
+        }
+    }
+    else if (options.conversionType == 0 && !options.shardDir.empty()) {
+        if (!options.silentMode) {
+            logMessage("\nConversion type set per file from the jobs", logFile);
+        }
+    }
+    else if (options.conversionType == 0) {
         options.conversionType = getUserConversionChoice(logFile);
     }
     else if (!options.silentMode) {
         logMessage("\nConversion type set from arguments: " + std::string(options.conversionType == 1 ? "BM to AB" : "AB to BM"), logFile);
     }
 
-    // Get the input file path(s)
-    auto inputPaths = getInputFilePaths(options, logFile);
+    // Open the record cache of each conversion (manifest lines may choose their own)
+    std::array<std::unique_ptr<RecordCache>, 2> recordCaches;
+    if (options.incremental) {
+        for (int conversionType = 1; conversionType <= 2; ++conversionType) {
+            if (options.conversionType != 0 && options.conversionType != conversionType && options.manifestFile.empty() &&
+                options.shardDir.empty()) {
+                continue;
+            }
+            try {
+                recordCaches[conversionType - 1] = std::make_unique<RecordCache>(RECORD_CACHE_FILE,
+                    conversionFingerprint(index.mapping(conversionType), conversionType));
+            }
+            catch (const std::exception& e) {
+                logErrorAndExit("ERROR - " + std::string(e.what()) + "\n", logFile);
+            }
+        }
+    }
+
+    // Initialize the trace recorder only when requested, so stages cost nothing otherwise
+    std::unique_ptr<TraceRecorder> tracer;
+    if (!options.traceFile.empty()) {
+        tracer = std::make_unique<TraceRecorder>();
+    }
+
+    // Open hardware performance counters only when requested
+    std::unique_ptr<PerfCounters> perfCounters;
+    if (options.perfCounters) {
+        if (options.reportFile.empty()) {
+            logMessage("WARNING - --perf-counters has no effect without --report", logFile);
+        }
+        else {
+            perfCounters = std::make_unique<PerfCounters>();
+            if (!perfCounters->available()) {
+                logMessage("WARNING - hardware performance counters unavailable (" + perfCounters->error() + ")", logFile);
+                perfCounters.reset();
+            }
+            else if (!perfCounters->error().empty() && !options.silentMode) {
+                logMessage("WARNING - some hardware performance counters unavailable (" + perfCounters->error() + ")", logFile);
+            }
+        }
+    }
+
+    // Get the input file path(s); a manifest is read line by line and the jobs of a worker are claimed one by one while
+    // the files are processed
+    std::unique_ptr<ManifestReader> manifest;
+    std::unique_ptr<ShardWorker> shardWorker;
+    std::vector<std::filesystem::path> inputPaths;
+    if (!options.shardDir.empty()) {
+        try {
+            shardWorker = std::make_unique<ShardWorker>(options.shardDir, claimTimeout);
+        }
+        catch (const std::exception& e) {
+            logErrorAndExit("ERROR - " + std::string(e.what()) + "\n", logFile);
+        }
+        logMessage("\nWorking on jobs from: " + options.shardDir.string() + " (worker " + shardWorker->workerId() + ")\n", logFile);
+    }
+    else if (!options.manifestFile.empty()) {
+        try {
+            manifest = std::make_unique<ManifestReader>(options.manifestFile);
+        }
+        catch (const std::exception& e) {
+            logErrorAndExit("ERROR - " + std::string(e.what()) + "\n", logFile);
+        }
+        logMessage("\nUsing files from manifest: " + options.manifestFile.string() + "\n", logFile);
+    }
+    else {
+        StageContext walkContext;
+        walkContext.tracer = tracer.get();
+        StageScope walkStage(walkContext, "directory walk", "pipeline");
+        inputPaths = getInputFilePaths(options, logFile);
+    }
 
     // Initialize vector to store the IDs of scripts that were updated during processing
     std::vector<std::string> updatedScriptIDs;
 
+    // Initialize the run report
+    RunReport runReport;
+    runReport.conversionType = options.conversionType;
+    runReport.dryRun = options.dryRun;
+    runReport.incremental = options.incremental;
+    runReport.keepFiles = !options.reportFile.empty();
+
+    // A dry run without profiles analyses the conversion choice as a single profile
+    std::vector<ConversionProfile> dryRunProfiles = profiles;
+    if (options.dryRun && dryRunProfiles.empty()) {
+        ConversionProfile profile;
+        profile.name = "dry run";
+        profile.conversionType = options.conversionType;
+        dryRunProfiles.push_back(std::move(profile));
+    }
+    runReport.perfCounters = perfCounters.get();
+
+    // Mappings the content probe checks each plugin against; none for the modes that do not run the handlers
+    std::vector<const CellMapping*> probeMappings;
+    if (!options.noProbe && !coverageIndex && !binaryPatch && !editPlan) {
+        for (const auto& profile : options.dryRun ? dryRunProfiles : profiles) {
+            probeMappings.push_back(profile.mapping ? profile.mapping.get() : &index.mapping(profile.conversionType));
+        }
+        if (probeMappings.empty()) {
+            probeMappings.push_back(&index.mapping(options.conversionType));
+        }
+    }
+
+    // Grid cells moved in each converted plugin, collected while the handlers run
+    CellConflictMap cellConflicts;
+    std::vector<CellTouch> touchedCells;
+
+    // Show a progress line on the console; the detailed messages then only go to the log file. The total of a shard
+    // batch is read from the job directory and that of a manifest from a counting pass over it
+    std::unique_ptr<ProgressLine> progress;
+    if (options.progress) {
+        std::uint64_t totalBytes = 0;
+        for (const auto& path : inputPaths) {
+            std::error_code sizeError;
+            const std::uintmax_t size = std::filesystem::file_size(path, sizeError);
+            totalBytes += sizeError ? 0 : size;
+        }
+        size_t totalFiles = inputPaths.size();
+        if (shardWorker) {
+            totalFiles = shardWorker->jobCount();
+        }
+        else if (manifest) {
+            totalFiles = countManifestPlugins(options.manifestFile);
+        }
+        progress = std::make_unique<ProgressLine>(totalFiles, totalBytes);
+        if (shardWorker) {
+            progress->setBatchDone([&shardWorker] { return shardWorker->jobsFinished(); });
+        }
+        setConsoleOutput(ConsoleOutput::WarningsOnly);
+    }
+
+    if (eventLog) {
+        ordered_json started;
+        started["version"] = PROGRAM_VERSION;
+        started["conversion"] = (options.conversionType == 0) ? "per file" : (options.conversionType == 1) ? "BM->AB" : "AB->BM";
+        started["dry_run"] = options.dryRun;
+        started["incremental"] = options.incremental;
+        if (shardWorker) {
+            started["shard"] = options.shardDir.string();
+            started["worker"] = shardWorker->workerId();
+        }
+        else if (manifest) {
+            started["manifest"] = options.manifestFile.string();
+        }
+        else {
+            started["files"] = inputPaths.size();
+        }
+        eventLog->emit("run_started", std::move(started));
+    }
+
     // Time start
     auto programStart = std::chrono::high_resolution_clock::now();
 
     // Sequential processing of each file
-    for (const auto& pluginImportPath : inputPaths) {
+    ManifestEntry entry;
+    size_t nextInputPath = 0;
+    auto nextEntry = [&]() {
+        if (shardWorker) {
+            return shardWorker->claim(entry, logFile);
+        }
+        if (manifest) {
+            return manifest->next(entry, logFile);
+        }
+        if (nextInputPath == inputPaths.size()) {
+            return false;
+        }
+        entry = ManifestEntry();
+        entry.path = inputPaths[nextInputPath++];
+        return true;
+    };
+    while (nextEntry()) {
+        const std::filesystem::path& pluginImportPath = entry.path;
+
         // Time file start
         auto fileStart = std::chrono::high_resolution_clock::now();
+        if (progress) {
+            progress->fileStarted();
+        }
+
+        // Settings of this file: a manifest line may choose its own conversion and options (edit plans, binary patches
+        // and the coverage index carry their own, and a dry run saves nothing)
+        ProgramOptions fileOptions = options;
+        if (!coverageIndex && !binaryPatch && !editPlan) {
+            applyManifestEntry(fileOptions, entry);
+            if (options.dryRun) {
+                fileOptions.savePlan = false;
+                fileOptions.savePatch = false;
+            }
+        }
+        std::vector<const CellMapping*> fileProbeMappings = fileOptions.noProbe ? std::vector<const CellMapping*>() : probeMappings;
+        std::vector<ConversionProfile> fileDryRunProfiles = dryRunProfiles;
+        if (fileOptions.conversionType != options.conversionType && profiles.empty()) {
+            if (!fileProbeMappings.empty()) {
+                fileProbeMappings = { &index.mapping(fileOptions.conversionType) };
+            }
+            if (!fileDryRunProfiles.empty()) {
+                fileDryRunProfiles.front().conversionType = fileOptions.conversionType;
+            }
+        }
 
         // Clear data
         updatedScriptIDs.clear();
+        touchedCells.clear();
 
         logMessage("Processing file: " + pluginImportPath.string(), logFile);
 
-        try {
-            // Define the output file path
-            std::filesystem::path jsonImportPath = pluginImportPath.parent_path() / (pluginImportPath.stem().string() + ".json");
+        FileReport fileReport;
+        fileReport.path = pluginImportPath;
+        if (fileOptions.conversionType != options.conversionType) {
+            fileReport.conversionType = fileOptions.conversionType;
+        }
 
-            // Convert the input file to .JSON
-            std::ostringstream convCmd;
-            convCmd << TES3CONV_COMMAND << " "
-                    << std::quoted(pluginImportPath.string()) << " "
-                    << std::quoted(jsonImportPath.string());
+        StageContext stageContext;
+        stageContext.tracer = tracer.get();
+        stageContext.fileName = pluginImportPath.filename().string();
+        stageContext.touchedCells = &touchedCells;
 
-            if (std::system(convCmd.str().c_str()) != 0) {
-                logMessage("ERROR - converting to .JSON failed for file: " + pluginImportPath.string() + "\n", logFile);
-                continue;
+        std::error_code sizeError;
+        fileReport.inputBytes = std::filesystem::file_size(pluginImportPath, sizeError);
+        if (sizeError) {
+            fileReport.inputBytes = 0;
+        }
+        if (!options.reportFile.empty() || eventLog) {
+            stageContext.stages = &fileReport.stages;
+            stageContext.perfCounters = perfCounters.get();
+        }
+        // Memory is only sampled when it is reported
+        if (!options.reportFile.empty() || eventLog || tracer) {
+            stageContext.peakRssBytes = &fileReport.peakRssBytes;
+            fileReport.baselineRssBytes = readCurrentRss();
+        }
+        if (eventLog) {
+            eventLog->setFile(pluginImportPath.string());
+            ordered_json started;
+            started["input_bytes"] = fileReport.inputBytes;
+            eventLog->emit("file_started", std::move(started));
+        }
+
+        try {
+            StageScope fileStage(stageContext, "file", "file");
+            if (coverageIndex) {
+                processPluginIndex(pluginImportPath, *coverageIndex, fileReport, stageContext, fileOptions, logFile);
             }
-            if (!options.silentMode) {
-                logMessage("Conversion to .JSON successful: " + jsonImportPath.string(), logFile);
+            else if (fileOptions.conversionType == 0 && profiles.empty()) {
+                fileReport.status = "failed";
+                fileReport.reason = "no conversion type";
+                logMessage("ERROR - no conversion type for file: " + pluginImportPath.string() + " (manifest line " +
+                           std::to_string(entry.line) + ")\n", logFile);
             }
-
-            // Load the generated JSON file
-            std::ifstream inputFile(jsonImportPath, std::ios::binary);
-            if (!inputFile.is_open()) {
-                logMessage("ERROR - failed to open JSON file: " + jsonImportPath.string() + "\n", logFile);
-                continue;
+            else if (!fileProbeMappings.empty() && skipIrrelevantPlugin(pluginImportPath, fileProbeMappings, fileReport, stageContext, fileOptions, logFile)) {
+                // Nothing the conversion could change; tes3conv never runs
             }
-
-            inputFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-            ordered_json inputData;
-            try {
-                inputFile >> inputData;
-
-                if (inputData.is_discarded()) {
-                    logMessage("ERROR - parsed JSON is invalid or empty: " + jsonImportPath.string() + "\n", logFile);
-                    continue;
-                }
+            else if (fileOptions.dryRun) {
+                processPluginDryRun(pluginImportPath, index, fileDryRunProfiles, fileReport, stageContext, fileOptions, logFile);
             }
-            catch (const std::exception& e) {
-                logMessage("ERROR - failed to parse JSON (" + jsonImportPath.string() + "): " + e.what() + "\n", logFile);
-                continue;
+            else if (binaryPatch) {
+                processPluginPatch(pluginImportPath, *binaryPatch, fileReport, stageContext, fileOptions, logFile);
             }
-
-            inputFile.close();
-
-            // Check if file was already converted
-            if (hasConversionTag(inputData, pluginImportPath, logFile)) {
-                std::filesystem::remove(jsonImportPath);
-                logMessage("ERROR - file " + pluginImportPath.string() + " was already converted - conversion skipped...", logFile);
-                if (options.silentMode) {
-                    logMessage("", logFile);
-                }
-                else {
-                    logMessage("Temporary .JSON file deleted: " + jsonImportPath.string() + "\n", logFile);
-                }
-
-                continue;
+            else if (editPlan) {
+                processPluginPlan(pluginImportPath, *editPlan, fileReport, stageContext, fileOptions, logFile);
             }
-
-            // Check the dependency order
-            auto [isValid, validMasters] = checkDependencyOrder(inputData, logFile);
-            if (!isValid) {
-                std::filesystem::remove(jsonImportPath);
-                logMessage("ERROR - required Parent Masters not found for file: " + pluginImportPath.string() + " - conversion skipped...", logFile);
-                if (options.silentMode) {
-                    logMessage("", logFile);
-                }
-                else {
-                    logMessage("Temporary .JSON file deleted: " + jsonImportPath.string() + "\n", logFile);
-                }
-
-                continue;
+            else if (profiles.empty()) {
+                processPluginFile(pluginImportPath, index, recordCaches[fileOptions.conversionType - 1].get(), updatedScriptIDs, fileReport,
+                    stageContext, fileOptions, logFile);
             }
-
-            // Initialize the replacements flag
-            int replacementsFlag = 0;
-
-            // Initialize the grid offsets based on user conversion choice
-            GridOffset offset = getGridOffset(options.conversionType);
-
-            // Process replacements
-            processGridValues(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-            processInteriorDoorsTranslation(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-            processNpcTravelDestinations(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-
-            processScriptAiEscortTranslation(db, inputData, offset, replacementsFlag, updatedScriptIDs, customCoordinates, options, logFile);
-            processScriptAiEscortCellTranslation(db, inputData, offset, replacementsFlag, updatedScriptIDs, customCoordinates, options, logFile);
-            processScriptAiFollowTranslation(db, inputData, offset, replacementsFlag, updatedScriptIDs, customCoordinates, options, logFile);
-            processScriptAiFollowCellTranslation(db, inputData, offset, replacementsFlag, updatedScriptIDs, customCoordinates, options, logFile);
-            processScriptAiTravelTranslation(db, inputData, offset, replacementsFlag, updatedScriptIDs, customCoordinates, options, logFile);
-            processScriptPositionTranslation(db, inputData, offset, replacementsFlag, updatedScriptIDs, customCoordinates, options, logFile);
-            processScriptPositionCellTranslation(db, inputData, offset, replacementsFlag, updatedScriptIDs, customCoordinates, options, logFile);
-            processScriptPlaceItemTranslation(db, inputData, offset, replacementsFlag, updatedScriptIDs, customCoordinates, options, logFile);
-            processScriptPlaceItemCellTranslation(db, inputData, offset, replacementsFlag, updatedScriptIDs, customCoordinates, options, logFile);
-
-            processDialogueAiEscortTranslation(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-            processDialogueAiEscortCellTranslation(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-            processDialogueAiFollowTranslation(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-            processDialogueAiFollowCellTranslation(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-            processDialogueAiTravelTranslation(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-            processDialoguePositionTranslation(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-            processDialoguePositionCellTranslation(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-            processDialoguePlaceItemTranslation(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-            processDialoguePlaceItemCellTranslation(db, inputData, offset, replacementsFlag, customCoordinates, options, logFile);
-
-            // Check if any replacements were made
-            if (replacementsFlag == 0) {
-                std::filesystem::remove(jsonImportPath);
-                logMessage("No replacements found for file: " + pluginImportPath.string() + " - conversion skipped...", logFile);
-                if (options.silentMode) {
-                    logMessage("", logFile);
-                }
-                else {
-                    logMessage("Temporary .JSON file deleted: " + jsonImportPath.string() + "\n", logFile);
-                }
-
-                continue;
+            else {
+                processPluginProfiles(pluginImportPath, index, profiles, fileReport, stageContext, fileOptions, logFile);
             }
+        }
+        catch (const std::exception& e) {
+            fileReport.status = "failed";
+            fileReport.reason = e.what();
+            logMessage("ERROR - failed to process file " + pluginImportPath.string() + ": " + e.what() + "\n", logFile);
+        }
 
-            // Log updated script IDs
-            logUpdatedScriptIDs(updatedScriptIDs, logFile);
+        // Time file total
+        auto fileEnd = std::chrono::high_resolution_clock::now();
+        finalizeFileReport(fileReport, std::chrono::duration<double>(fileEnd - fileStart).count());
+        if (!options.silentMode && !options.dryRun && fileReport.status == "converted") {
+            logFileTimings(fileReport, logFile);
+        }
 
-            // Define conversion prefix
-            std::string convPrefix = (options.conversionType == 1) ? "BM->AB" : "AB->BM";
+        if (progress) {
+            progress->fileFinished(fileReport.inputBytes, fileReport.recordCount);
+        }
+        if (eventLog) {
+            recordFileEvents(*eventLog, fileReport);
+            eventLog->setFile("");
+            eventLog->flush();
+        }
 
-            // Add conversion tag to header
-            if (!addConversionTag(inputData, convPrefix, options, logFile)) {
-                logMessage("ERROR - could not find or modify header description\n", logFile);
-                continue;
-            }
+        // Claim the moved cells only for plugins that are (or would be) converted
+        if (fileReport.status == "converted") {
+            cellConflicts.add(pluginImportPath.string(), fileOptions.conversionType, touchedCells);
+        }
 
-            // Save the modified data to .JSON file
-            auto newJsonName = std::format("TEMP_{}{}", pluginImportPath.stem().string(), ".json");
-            std::filesystem::path jsonExportPath = pluginImportPath.parent_path() / newJsonName;
+        // Hand the outcome back to the job directory
+        if (shardWorker) {
+            shardWorker->complete(fileReportToJson(fileReport, runReport), logFile);
+        }
 
-            if (!saveJsonToFile(jsonExportPath, inputData, options, logFile)) {
-                logMessage("ERROR - failed to save modified data to .JSON file: " + jsonExportPath.string() + "\n", logFile);
-                continue;
-            }
+        addFileReport(runReport, std::move(fileReport));
+    }
 
-            // Create backup before modifying original file
-            if (!createBackup(pluginImportPath, options, logFile)) {
-                std::filesystem::remove(jsonImportPath);
-                if (!options.silentMode) {
-                    logMessage("Temporary .JSON file deleted: " + jsonImportPath.string(), logFile);
-                }
+    if (progress) {
+        progress->finish();
+        setConsoleOutput(ConsoleOutput::All);
+    }
 
-                continue;
-            }
+    if (manifest && !options.silentMode) {
+        logMessage("\nManifest: " + std::to_string(manifest->linesRead()) + " lines read, " +
+                   std::to_string(manifest->linesSkipped()) + " skipped", logFile);
+    }
+    if (shardWorker && !options.silentMode) {
+        logMessage("\nShard worker " + shardWorker->workerId() + ": " + std::to_string(shardWorker->jobsDone()) + " jobs done, " +
+                   std::to_string(shardWorker->claimsRequeued()) + " expired claims requeued", logFile);
+    }
 
-            // Save converted file with original name
-            if (!convertJsonToEsp(jsonExportPath, pluginImportPath, options, logFile)) {
-                logMessage("ERROR - failed to convert .JSON back to .ESP|ESM: " + pluginImportPath.string() + "\n", logFile);
-                continue;
-            }
+    // Report the cells edited by more than one plugin
+    runReport.cellConflicts = cellConflicts.conflicts();
+    logCellConflicts(runReport.cellConflicts, logFile);
 
-            // Clean up temporary .JSON files
-            std::filesystem::remove(jsonImportPath);
-            std::filesystem::remove(jsonExportPath);
-            if (!options.silentMode) {
-                logMessage("Temporary .JSON files deleted: " + jsonImportPath.string() + "\n" +
-                           "                          and: " + jsonExportPath.string(), logFile);
-            }
+    // Drop plugins that were deleted since they were indexed
+    if (coverageIndex) {
+        size_t removed = coverageIndex->prune();
+        logMessage("\nCoverage index: " + std::to_string(coverageIndex->pluginCount()) + " plugins indexed, " +
+                   std::to_string(removed) + " removed plugins dropped", logFile);
+    }
 
-            // Time file total
-            auto fileEnd = std::chrono::high_resolution_clock::now();
-            auto fileDuration = fileEnd - fileStart;
-            auto seconds = std::chrono::duration<double>(fileDuration).count();
-            if (!options.silentMode) {
-                logMessage(std::format("\nFile converted in: {:.3f} seconds\n", seconds), logFile);
-            }
+    // Time total
+    auto programEnd = std::chrono::high_resolution_clock::now();
+    runReport.totalSeconds = std::chrono::duration<double>(programEnd - programStart).count();
+    if (eventLog) {
+        ordered_json finished;
+        finished["files"] = runReport.totals.files;
+        for (const char* status : { "converted", "skipped", "failed" }) {
+            finished[status] = runReport.totals.count(status);
         }
-        catch (const std::exception& e) {
-            // Time error
-            auto fileEnd = std::chrono::high_resolution_clock::now();
-            auto fileDuration = std::chrono::duration_cast<std::chrono::milliseconds>(fileEnd - fileStart);
-
-            logMessage("ERROR - failed to process file " + pluginImportPath.string() + ": " + e.what() + "\n", logFile);
+        finished["cell_conflicts"] = runReport.cellConflicts.size();
+        finished["seconds"] = runReport.totalSeconds;
+        eventLog->emit("run_finished", std::move(finished));
+        eventLog->flush();
+    }
+    if (!options.silentMode || options.dryRun) {
+        logRunSummary(runReport, logFile);
+    }
 
-            // Clear data in case of error
-            updatedScriptIDs.clear();
-            continue;
-        }
+    // Write the machine-readable report
+    if (!options.reportFile.empty()) {
+        writeRunReport(options.reportFile, runReport, logFile);
     }
 
-    // Time total
-    auto programEnd = std::chrono::high_resolution_clock::now();
-    auto programDuration = programEnd - programStart;
-    auto seconds = std::chrono::duration<double>(programDuration).count();
-    if (!options.silentMode) {
-        logMessage(std::format("\nTotal processing time: {:.3f} seconds", seconds), logFile);
+    // Write the trace
+    if (tracer) {
+        tracer->writeToFile(options.traceFile, logFile);
     }
 
     // Close the database
@@ -0,0 +1,28 @@
+#include "ab_data_processor.h"
+#include "ab_engines.h"
+
+// Reference engine: the production handler sequence
+static void runReferenceEngine(const EngineContext& context, ordered_json& inputData, int& replacementsFlag,
+    std::vector<std::string>& updatedScriptIDs) {
+    StageContext stageContext;
+    processAllReplacements(context.index.mapping(context.options.conversionType), inputData, replacementsFlag,
+        updatedScriptIDs, stageContext, context.logFile);
+}
+
+// Function to list all engines known to the harnesses; the first one is the reference implementation
+const std::vector<ConversionEngine>& conversionEngines() {
+    static const std::vector<ConversionEngine> engines = {
+        { "reference", runReferenceEngine },
+    };
+    return engines;
+}
+
+// Function to find an engine by name (nullptr when unknown)
+const ConversionEngine* findConversionEngine(const std::string& name) {
+    for (const auto& engine : conversionEngines()) {
+        if (name == engine.name) {
+            return &engine;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ab_library.h"
+#include "ab_options.h"
+
+// Structure for storing everything an engine needs besides the document itself
+struct EngineContext {
+    const CoordinateIndex& index;
+    const ProgramOptions& options;
+    std::ofstream& logFile;
+};
+
+// Signature of a conversion engine: rewrites the document in place like the reference handlers do
+using EngineFunction = void (*)(const EngineContext& context, ordered_json& inputData, int& replacementsFlag,
+    std::vector<std::string>& updatedScriptIDs);
+
+// Structure for storing a named conversion engine
+struct ConversionEngine {
+    const char* name;
+    EngineFunction run;
+};
+
+// Function to list all engines known to the harnesses; the first one is the reference implementation
+const std::vector<ConversionEngine>& conversionEngines();
+
+// Function to find an engine by name (nullptr when unknown)
+const ConversionEngine* findConversionEngine(const std::string& name);
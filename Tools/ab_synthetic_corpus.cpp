@@ -0,0 +1,248 @@
+#include <cmath>
+#include <format>
+
+#include <sqlite3.h>
+
+#include "ab_synthetic_corpus.h"
+
+// Uniform integer in [low, high]
+int SyntheticRandom::nextInt(int low, int high) {
+    if (high <= low) {
+        return low;
+    }
+    return low + static_cast<int>(engine_() % static_cast<std::uint32_t>(high - low + 1));
+}
+
+// Uniform real in [low, high)
+double SyntheticRandom::nextReal(double low, double high) {
+    return low + (high - low) * (static_cast<double>(engine_()) / 4294967296.0);
+}
+
+// True with the given probability
+bool SyntheticRandom::chance(double probability) {
+    return nextReal(0.0, 1.0) < probability;
+}
+
+// Function to load the relocatable grid cells from the coordinate database
+std::vector<std::pair<int, int>> loadRegionCells(const std::string& databasePath) {
+    std::vector<std::pair<int, int>> cells;
+
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(databasePath.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        if (db) sqlite3_close(db);
+        return cells;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT BM_Grid_X, BM_Grid_Y FROM [tes3_ab_cell_x-y_data]", -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            cells.emplace_back(sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1));
+        }
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+
+    return cells;
+}
+
+// Helper function to pick a grid cell, mostly inside the relocatable region
+static std::pair<int, int> pickCell(SyntheticRandom& random, const std::vector<std::pair<int, int>>& regionCells) {
+    if (!regionCells.empty() && random.chance(0.7)) {
+        return regionCells[random.nextInt(0, static_cast<int>(regionCells.size()) - 1)];
+    }
+    return { random.nextInt(-40, 40), random.nextInt(-40, 40) };
+}
+
+// Helper function to format a world coordinate the way scripts write them (integer or decimal)
+static std::string formatCoordinate(SyntheticRandom& random, double value) {
+    switch (random.nextInt(0, 2)) {
+    case 0: return std::format("{}", static_cast<long long>(std::floor(value)));
+    case 1: return std::format("{:.1f}", value);
+    default: return std::format("{:.3f}", value);
+    }
+}
+
+// Helper function to pick an argument separator: spaces, commas or both
+static std::string separator(SyntheticRandom& random) {
+    static const char* const separators[] = { " ", ", ", ",", "  ", " ,", ",  " };
+    return separators[random.nextInt(0, 5)];
+}
+
+// Helper function to pick an object or actor ID, bare or quoted with spaces
+static std::string objectId(SyntheticRandom& random) {
+    static const char* const bareIds[] = { "player", "rock_01", "npc_guard", "misc_com_bottle_01", "Ulfgar" };
+    static const char* const quotedIds[] = { "\"Skaal Hunter\"", "\"misc dwrv coin\"", "\"Frykte\"", "\"Thirsk guard 2\"" };
+    if (random.chance(0.5)) {
+        return bareIds[random.nextInt(0, 4)];
+    }
+    return quotedIds[random.nextInt(0, 3)];
+}
+
+// Helper function to pick a cell ID, bare or quoted with spaces
+static std::string cellId(SyntheticRandom& random) {
+    static const char* const cellIds[] = { "\"Thirsk, Main Hall\"", "\"Skaal Village\"", "Fort_Frostmoth", "\"Raven Rock, Factor's Estate\"" };
+    return cellIds[random.nextInt(0, 3)];
+}
+
+// Function to generate a random script body made of coordinate commands, including quoted IDs, optional commas and reset arguments
+std::string generateScriptText(SyntheticRandom& random, const std::vector<std::pair<int, int>>& regionCells, int lines) {
+    std::string text = "Begin synthetic_script\r\n";
+
+    for (int line = 0; line < lines; ++line) {
+        auto [gridX, gridY] = pickCell(random, regionCells);
+        std::string x = formatCoordinate(random, gridX * 8192.0 + random.nextReal(0.0, 8192.0));
+        std::string y = formatCoordinate(random, gridY * 8192.0 + random.nextReal(0.0, 8192.0));
+        std::string z = formatCoordinate(random, random.nextReal(-500.0, 2000.0));
+        std::string rotation = std::format("{}", random.nextInt(0, 359));
+        std::string reset = random.chance(0.5) ? separator(random) + std::format("{}", random.nextInt(0, 1)) : "";
+        std::string duration = std::format("{}", random.nextInt(0, 600));
+        std::string prefix = random.chance(0.2) ? objectId(random) + "->" : "";
+
+        std::string command;
+        switch (random.nextInt(0, 11)) {
+        case 0: command = "AiEscort" + separator(random) + objectId(random) + separator(random) + duration + separator(random) + x + separator(random) + y + separator(random) + z + reset; break;
+        case 1: command = "AiEscortCell" + separator(random) + objectId(random) + separator(random) + cellId(random) + separator(random) + duration + separator(random) + x + separator(random) + y + separator(random) + z + reset; break;
+        case 2: command = "AiFollow" + separator(random) + objectId(random) + separator(random) + duration + separator(random) + x + separator(random) + y + separator(random) + z + reset; break;
+        case 3: command = "AIFollowCell" + separator(random) + objectId(random) + separator(random) + cellId(random) + separator(random) + duration + separator(random) + x + separator(random) + y + separator(random) + z + reset; break;
+        case 4: command = "AiTravel" + separator(random) + x + separator(random) + y + separator(random) + z + reset; break;
+        case 5: command = "Position" + separator(random) + x + separator(random) + y + separator(random) + z + separator(random) + rotation; break;
+        case 6: command = "PositionCell" + separator(random) + x + separator(random) + y + separator(random) + z + separator(random) + rotation + separator(random) + cellId(random); break;
+        case 7: command = "PlaceItem" + separator(random) + objectId(random) + separator(random) + x + separator(random) + y + separator(random) + z + separator(random) + rotation; break;
+        case 8: command = "PlaceItemCell" + separator(random) + objectId(random) + separator(random) + cellId(random) + separator(random) + x + separator(random) + y + separator(random) + z + separator(random) + rotation; break;
+        case 9: command = "if ( GetDistance player < " + duration + " )"; break;
+        case 10: command = "MessageBox \"The ending of the words is ALMSIVI\""; break;
+        default: command = "set synthetic_state to " + duration; break;
+        }
+
+        // Vary the command case, scripts are case-insensitive
+        if (random.chance(0.1)) {
+            for (char& c : command) {
+                if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+            }
+        }
+
+        text += "    " + prefix + command + "\r\n";
+    }
+
+    text += "End";
+    return text;
+}
+
+// Helper function to build a world position array inside the given grid cell
+static ordered_json worldPosition(SyntheticRandom& random, int gridX, int gridY) {
+    return ordered_json::array({ gridX * 8192.0 + random.nextReal(0.0, 8192.0), gridY * 8192.0 + random.nextReal(0.0, 8192.0), random.nextReal(-500.0, 2000.0) });
+}
+
+// Function to generate a synthetic plugin (tes3conv .JSON layout) with cells, doors, travel services, scripts and dialogue
+ordered_json generateSyntheticPlugin(const SyntheticPluginSpec& spec, const std::vector<std::pair<int, int>>& regionCells, std::uint32_t seed) {
+    SyntheticRandom random(seed);
+    ordered_json plugin = ordered_json::array();
+
+    ordered_json header;
+    header["type"] = "Header";
+    header["flags"] = "";
+    header["version"] = 1.3;
+    header["file_type"] = "Esp";
+    header["author"] = "synthetic";
+    header["description"] = std::format("Synthetic plugin {}", seed);
+    header["num_objects"] = 0;
+    header["masters"] = ordered_json::array({ ordered_json::array({ "Morrowind.esm", 79837557 }),
+        ordered_json::array({ "Tribunal.esm", 4565686 }), ordered_json::array({ "Bloodmoon.esm", 9631798 }) });
+    plugin.push_back(std::move(header));
+
+    for (int i = 0; i < spec.exteriorCells; ++i) {
+        auto [gridX, gridY] = pickCell(random, regionCells);
+
+        ordered_json cell;
+        cell["type"] = "Cell";
+        cell["flags"] = "";
+        cell["id"] = "";
+        cell["data"] = { { "flags", "" }, { "grid", ordered_json::array({ gridX, gridY }) } };
+        cell["references"] = ordered_json::array();
+        for (int r = 0; r < spec.referencesPerCell; ++r) {
+            ordered_json reference;
+            reference["mast_index"] = 0;
+            reference["refr_index"] = r + 1;
+            reference["id"] = std::format("synthetic_object_{}", r);
+            if (random.chance(0.9)) {
+                reference["temporary"] = true;
+            }
+            if (random.chance(0.05)) {
+                reference["deleted"] = true;
+            }
+            reference["translation"] = worldPosition(random, gridX, gridY);
+            reference["rotation"] = ordered_json::array({ 0.0, 0.0, random.nextReal(0.0, 6.28) });
+            cell["references"].push_back(std::move(reference));
+        }
+        plugin.push_back(std::move(cell));
+
+        ordered_json landscape;
+        landscape["type"] = "Landscape";
+        landscape["flags"] = "";
+        landscape["grid"] = ordered_json::array({ gridX, gridY });
+        plugin.push_back(std::move(landscape));
+
+        if (random.chance(0.5)) {
+            ordered_json pathGrid;
+            pathGrid["type"] = "PathGrid";
+            pathGrid["flags"] = "";
+            pathGrid["cell"] = "";
+            pathGrid["data"] = { { "grid", ordered_json::array({ gridX, gridY }) }, { "granularity", 1024 } };
+            plugin.push_back(std::move(pathGrid));
+        }
+    }
+
+    for (int i = 0; i < spec.interiorCells; ++i) {
+        ordered_json cell;
+        cell["type"] = "Cell";
+        cell["flags"] = "";
+        cell["id"] = std::format("Synthetic Interior {}", i);
+        cell["data"] = { { "flags", "IS_INTERIOR" }, { "grid", ordered_json::array({ 0, 0 }) } };
+        cell["references"] = ordered_json::array();
+        for (int r = 0; r < 3; ++r) {
+            auto [gridX, gridY] = pickCell(random, regionCells);
+            ordered_json door;
+            door["mast_index"] = 0;
+            door["refr_index"] = r + 1;
+            door["id"] = "door_synthetic";
+            door["translation"] = ordered_json::array({ 0.0, 0.0, 0.0 });
+            door["rotation"] = ordered_json::array({ 0.0, 0.0, 0.0 });
+            door["destination"] = { { "translation", worldPosition(random, gridX, gridY) }, { "rotation", ordered_json::array({ 0.0, 0.0, 0.0 }) } };
+            cell["references"].push_back(std::move(door));
+        }
+        plugin.push_back(std::move(cell));
+    }
+
+    for (int i = 0; i < spec.npcs; ++i) {
+        ordered_json npc;
+        npc["type"] = "Npc";
+        npc["flags"] = "";
+        npc["id"] = std::format("synthetic_npc_{}", i);
+        npc["travel_destinations"] = ordered_json::array();
+        for (int d = 0; d < 2; ++d) {
+            auto [gridX, gridY] = pickCell(random, regionCells);
+            npc["travel_destinations"].push_back({ { "translation", worldPosition(random, gridX, gridY) }, { "rotation", ordered_json::array({ 0.0, 0.0, 0.0 }) } });
+        }
+        plugin.push_back(std::move(npc));
+    }
+
+    for (int i = 0; i < spec.scripts; ++i) {
+        ordered_json script;
+        script["type"] = "Script";
+        script["flags"] = "";
+        script["id"] = std::format("synthetic_script_{}", i);
+        script["text"] = generateScriptText(random, regionCells, spec.scriptLines);
+        plugin.push_back(std::move(script));
+    }
+
+    for (int i = 0; i < spec.dialogues; ++i) {
+        ordered_json info;
+        info["type"] = "DialogueInfo";
+        info["flags"] = "";
+        info["id"] = std::format("{}", 1000 + i);
+        info["script_text"] = generateScriptText(random, regionCells, 2);
+        plugin.push_back(std::move(info));
+    }
+
+    return plugin;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ab_options.h"
+
+// Structure for describing the size of a generated plugin
+struct SyntheticPluginSpec {
+    int exteriorCells = 8;
+    int referencesPerCell = 6;
+    int interiorCells = 2;
+    int npcs = 2;
+    int scripts = 4;
+    int scriptLines = 12;
+    int dialogues = 4;
+};
+
+// Deterministic random source (same sequence on every standard library)
+class SyntheticRandom {
+public:
+    explicit SyntheticRandom(std::uint32_t seed) : engine_(seed) {}
+
+    // Uniform integer in [low, high]
+    int nextInt(int low, int high);
+
+    // Uniform real in [low, high)
+    double nextReal(double low, double high);
+
+    // True with the given probability
+    bool chance(double probability);
+
+private:
+    std::mt19937 engine_;
+};
+
+// Function to load the relocatable grid cells from the coordinate database
+std::vector<std::pair<int, int>> loadRegionCells(const std::string& databasePath);
+
+// Function to generate a random script body made of coordinate commands, including quoted IDs, optional commas and reset arguments
+std::string generateScriptText(SyntheticRandom& random, const std::vector<std::pair<int, int>>& regionCells, int lines);
+
+// Function to generate a synthetic plugin (tes3conv .JSON layout) with cells, doors, travel services, scripts and dialogue
+ordered_json generateSyntheticPlugin(const SyntheticPluginSpec& spec, const std::vector<std::pair<int, int>>& regionCells, std::uint32_t seed);
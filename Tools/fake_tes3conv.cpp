@@ -0,0 +1,61 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+#include <thread>
+
+// Local stand-in for tes3conv used by the throughput harness: copies the input to the output in both
+// directions (the synthetic plugins already hold .JSON), after a configurable delay and CPU cost.
+//
+// TES3AB_FAKE_LATENCY_MS     idle time per run (process start-up, disk), default 0
+// TES3AB_FAKE_CPU_MS         busy time per run, default 0
+// TES3AB_FAKE_CPU_MS_PER_MB  additional busy time per MB of input, default 0
+
+// Helper function to read a numeric setting from the environment
+static double environmentValue(const char* name) {
+    const char* value = std::getenv(name);
+    return value ? std::atof(value) : 0.0;
+}
+
+// Helper function to keep one core busy for the given time
+static void burnCpu(double milliseconds) {
+    auto end = std::chrono::steady_clock::now() + std::chrono::duration<double, std::milli>(milliseconds);
+    volatile unsigned long long state = 1;
+    while (std::chrono::steady_clock::now() < end) {
+        for (int i = 0; i < 4096; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+    }
+}
+
+// Main function
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: tes3conv <input> <output>\n";
+        return EXIT_FAILURE;
+    }
+
+    std::error_code error;
+    auto inputBytes = std::filesystem::file_size(argv[1], error);
+    if (error) {
+        std::cerr << "ERROR - cannot read " << argv[1] << ": " << error.message() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    double latency = environmentValue("TES3AB_FAKE_LATENCY_MS");
+    double cpu = environmentValue("TES3AB_FAKE_CPU_MS") + environmentValue("TES3AB_FAKE_CPU_MS_PER_MB") * inputBytes / (1024.0 * 1024.0);
+    if (latency > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(latency));
+    }
+    if (cpu > 0.0) {
+        burnCpu(cpu);
+    }
+
+    std::filesystem::copy_file(argv[1], argv[2], std::filesystem::copy_options::overwrite_existing, error);
+    if (error) {
+        std::cerr << "ERROR - cannot write " << argv[2] << ": " << error.message() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ab_coord_processor.h"
+#include "ab_database.h"
+#include "ab_engines.h"
+#include "ab_library.h"
+#include "ab_logger.h"
+#include "ab_options.h"
+#include "ab_synthetic_corpus.h"
+
+// Differential fuzzer for the script and dialogue command rewrites: feeds random and mutated script bodies
+// to the reference engine and a candidate engine, requires identical edits and flags pathological runtimes.
+// Built as a standalone mutator by default, or as a libFuzzer target with AB_LIBFUZZER.
+
+// Structure for storing the shared fuzzing state
+struct FuzzState {
+    std::unique_ptr<CoordinateIndex> index;
+    std::vector<std::pair<int, int>> regionCells;
+    const ConversionEngine* reference = nullptr;
+    const ConversionEngine* candidate = nullptr;
+    std::ofstream logFile;
+    std::filesystem::path findingsDir = "fuzz_findings";
+    double slowMilliseconds = 250.0;
+    size_t maxLength = 8192;
+    int findings = 0;
+};
+
+// Structure for storing what an engine did with one input
+struct FuzzOutcome {
+    std::string scriptText;
+    std::string dialogueText;
+    int replacementsFlag = 0;
+    std::vector<std::string> updatedScriptIDs;
+    std::string exception;
+    double milliseconds = 0.0;
+};
+
+// Helper function to escape a script body for one-line printing
+static std::string escapeText(const std::string& text, size_t limit = 160) {
+    std::string result;
+    for (size_t i = 0; i < text.size() && i < limit; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '\r') result += "\\r";
+        else if (c == '\n') result += "\\n";
+        else if (c < 0x20 || c >= 0x7f) result += std::format("\\x{:02x}", c);
+        else result += static_cast<char>(c);
+    }
+    if (text.size() > limit) result += "...";
+    return result;
+}
+
+// Function to run one engine over a document holding the input as a script and as a dialogue result
+static FuzzOutcome runOutcome(FuzzState& state, const ConversionEngine& engine, const std::string& text, int conversionType) {
+    ordered_json document = ordered_json::array();
+    document.push_back({ { "type", "Script" }, { "flags", "" }, { "id", "fuzz_script" }, { "text", text } });
+    document.push_back({ { "type", "DialogueInfo" }, { "flags", "" }, { "id", "1" }, { "script_text", text } });
+
+    ProgramOptions options;
+    options.silentMode = true;
+    options.conversionType = conversionType;
+    EngineContext context{ *state.index, options, state.logFile };
+
+    FuzzOutcome outcome;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        engine.run(context, document, outcome.replacementsFlag, outcome.updatedScriptIDs);
+        outcome.scriptText = document[0]["text"].get<std::string>();
+        outcome.dialogueText = document[1]["script_text"].get<std::string>();
+    }
+    catch (const std::exception& e) {
+        outcome.exception = e.what();
+    }
+    outcome.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return outcome;
+}
+
+// Helper function to describe the first difference between two outcomes (empty when identical)
+static std::string describeDifference(const FuzzOutcome& expected, const FuzzOutcome& actual) {
+    auto differingText = [](const char* field, const std::string& a, const std::string& b) -> std::string {
+        auto mismatch = std::mismatch(a.begin(), a.end(), b.begin(), b.end());
+        size_t offset = static_cast<size_t>(mismatch.first - a.begin());
+        size_t start = offset > 24 ? offset - 24 : 0;
+        return std::format("{} differs at byte {}: \"{}\" vs \"{}\"", field, offset,
+            escapeText(a.substr(start, 48)), escapeText(b.substr(start, 48)));
+    };
+
+    if (expected.exception != actual.exception) {
+        return std::format("exception '{}' vs '{}'", expected.exception, actual.exception);
+    }
+    if (expected.scriptText != actual.scriptText) {
+        return differingText("script text", expected.scriptText, actual.scriptText);
+    }
+    if (expected.dialogueText != actual.dialogueText) {
+        return differingText("dialogue text", expected.dialogueText, actual.dialogueText);
+    }
+    if (expected.replacementsFlag != actual.replacementsFlag) {
+        return std::format("replacements flag {} vs {}", expected.replacementsFlag, actual.replacementsFlag);
+    }
+    if (expected.updatedScriptIDs != actual.updatedScriptIDs) {
+        return std::format("{} updated script IDs vs {}", expected.updatedScriptIDs.size(), actual.updatedScriptIDs.size());
+    }
+    return {};
+}
+
+// Function to save an input that produced a finding and report it
+static void recordFinding(FuzzState& state, const std::string& kind, const std::string& detail, const std::string& text) {
+    std::filesystem::create_directories(state.findingsDir);
+    std::filesystem::path path = state.findingsDir / std::format("{}_{:04d}.txt", kind, ++state.findings);
+    std::ofstream output(path, std::ios::binary);
+    output << text;
+
+    std::cout << std::format("{}: {}\n  input ({} bytes, saved to {}): {}\n", kind, detail, text.size(), path.string(), escapeText(text));
+}
+
+// Function to check a single input in both conversion directions, returns true if no finding was recorded
+static bool checkInput(FuzzState& state, const std::string& text) {
+    if (text.size() > state.maxLength) {
+        return true;
+    }
+
+    bool clean = true;
+    for (int conversionType : { 1, 2 }) {
+        FuzzOutcome expected = runOutcome(state, *state.reference, text, conversionType);
+        FuzzOutcome actual = runOutcome(state, *state.candidate, text, conversionType);
+        const char* direction = conversionType == 1 ? "BM->AB" : "AB->BM";
+
+        std::string difference = describeDifference(expected, actual);
+        if (!difference.empty()) {
+            recordFinding(state, "divergence", std::format("{} {} vs reference: {}", direction, state.candidate->name, difference), text);
+            clean = false;
+        }
+        else if (!expected.exception.empty()) {
+            recordFinding(state, "exception", std::format("{} both engines threw: {}", direction, expected.exception), text);
+            clean = false;
+        }
+
+        double slowest = std::max(expected.milliseconds, actual.milliseconds);
+        if (slowest > state.slowMilliseconds) {
+            recordFinding(state, "slow", std::format("{} reference {:.1f} ms, {} {:.1f} ms", direction,
+                expected.milliseconds, state.candidate->name, actual.milliseconds), text);
+            clean = false;
+        }
+    }
+    return clean;
+}
+
+// Function to mutate a script body with edits that target the command grammar: separators, quotes, signs, decimals and repeats
+static std::string mutateScript(SyntheticRandom& random, std::string text) {
+    static const char* const tokens[] = {
+        " ", ",", ", ", "\"", "-", ".", "0", "9", "\r\n", "->", "\t", ",,", "  ", "1.5", "-8192", "99999999",
+        "AiEscort ", "AiEscortCell ", "AiFollow ", "AiFollowCell ", "AiTravel ", "Position ", "PositionCell ",
+        "PlaceItem ", "PlaceItemCell ", "\"Skaal Village\"", "player",
+    };
+    constexpr int tokenCount = static_cast<int>(sizeof(tokens) / sizeof(tokens[0]));
+
+    int edits = random.nextInt(1, 8);
+    for (int i = 0; i < edits; ++i) {
+        size_t position = text.empty() ? 0 : static_cast<size_t>(random.nextInt(0, static_cast<int>(text.size())));
+        switch (random.nextInt(0, 5)) {
+        case 0:
+            // Insert a grammar token
+            text.insert(position, tokens[random.nextInt(0, tokenCount - 1)]);
+            break;
+        case 1:
+            // Delete a short range
+            if (position < text.size()) text.erase(position, static_cast<size_t>(random.nextInt(1, 8)));
+            break;
+        case 2:
+            // Replace a byte with a random printable one
+            if (position < text.size()) text[position] = static_cast<char>(random.nextInt(0x20, 0x7e));
+            break;
+        case 3:
+            // Duplicate a range, which builds up long command chains
+            if (position < text.size()) {
+                size_t length = std::min(text.size() - position, static_cast<size_t>(random.nextInt(1, 64)));
+                text.insert(position, text.substr(position, length));
+            }
+            break;
+        case 4:
+            // Long runs of whitespace and commas stress backtracking
+            text.insert(position, std::string(static_cast<size_t>(random.nextInt(16, 512)), random.chance(0.5) ? ' ' : ','));
+            break;
+        default:
+            // Long digit runs stress number parsing
+            text.insert(position, std::string(static_cast<size_t>(random.nextInt(8, 400)), static_cast<char>('0' + random.nextInt(0, 9))));
+            break;
+        }
+    }
+    return text;
+}
+
+// Function to open the database and pick the engines
+static bool initializeState(FuzzState& state, const std::string& databasePath, const std::string& customPath, const std::string& engineName) {
+    state.reference = &conversionEngines().front();
+    state.candidate = engineName.empty() ? &conversionEngines().back() : findConversionEngine(engineName);
+    if (state.candidate == nullptr) {
+        std::cerr << "ERROR - unknown engine: " << engineName << "\n";
+        return false;
+    }
+
+    if (!std::filesystem::exists(databasePath)) {
+        std::cerr << "ERROR - database file '" << databasePath << "' not found!\n";
+        return false;
+    }
+    state.logFile.open("tes3_ab_fuzz.log", std::ios::trunc);
+    // Mutated inputs warn about unreadable commands all the time; outcomes are compared, not logs
+    setLogLevel(LogLevel::Error);
+    std::unordered_set<std::pair<int, int>, PairHash> customCoordinates;
+    if (std::filesystem::exists(customPath)) {
+        loadCustomGridCoordinates(customPath, customCoordinates, false, state.logFile);
+    }
+    state.index = std::make_unique<CoordinateIndex>(Database(databasePath), std::move(customCoordinates));
+    state.regionCells = loadRegionCells(databasePath);
+    return true;
+}
+
+#ifdef AB_LIBFUZZER
+
+// libFuzzer entry point; the database and engine come from TES3AB_FUZZ_DB and TES3AB_FUZZ_ENGINE
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, size_t size) {
+    static FuzzState state;
+    static bool initialized = [] {
+        const char* databasePath = std::getenv("TES3AB_FUZZ_DB");
+        const char* engineName = std::getenv("TES3AB_FUZZ_ENGINE");
+        return initializeState(state, databasePath ? databasePath : "tes3_ab_cell_x-y_data.db",
+            "tes3_ab_custom_cell_x-y_data.txt", engineName ? engineName : "");
+    }();
+
+    if (!initialized) {
+        std::abort();
+    }
+    if (!checkInput(state, std::string(reinterpret_cast<const char*>(data), size))) {
+        std::abort();
+    }
+    return 0;
+}
+
+#else
+
+// Function to print usage information
+static void printUsage() {
+    std::cout << "Usage: tes3_ab_fuzz [OPTIONS] [input files...]\n\n"
+              << "Options:\n"
+              << "  --iterations <count>  Number of generated and mutated inputs (default 2000)\n"
+              << "  --seed <number>       Random seed (default 1)\n"
+              << "  --engine <name>       Candidate engine compared against the reference (default: last registered)\n"
+              << "  --slow-ms <ms>        Runtime per input and direction that counts as pathological (default 250)\n"
+              << "  --max-length <bytes>  Skip inputs longer than this (default 8192)\n"
+              << "  --findings <dir>      Directory for inputs that produced findings (default fuzz_findings)\n"
+              << "  --db <file>           Coordinate database (default tes3_ab_cell_x-y_data.db)\n"
+              << "  --custom <file>       Custom coordinates file (default tes3_ab_custom_cell_x-y_data.txt)\n\n"
+              << "Input files are replayed as script bodies before fuzzing (e.g. saved findings).\n";
+}
+
+// Main function
+int main(int argc, char* argv[]) {
+    FuzzState state;
+    std::string databasePath = "tes3_ab_cell_x-y_data.db";
+    std::string customPath = "tes3_ab_custom_cell_x-y_data.txt";
+    std::string engineName;
+    std::vector<std::filesystem::path> replayFiles;
+    int iterations = 2000;
+    std::uint32_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) iterations = std::atoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--engine" && i + 1 < argc) engineName = argv[++i];
+        else if (arg == "--slow-ms" && i + 1 < argc) state.slowMilliseconds = std::atof(argv[++i]);
+        else if (arg == "--max-length" && i + 1 < argc) state.maxLength = static_cast<size_t>(std::atol(argv[++i]));
+        else if (arg == "--findings" && i + 1 < argc) state.findingsDir = argv[++i];
+        else if (arg == "--db" && i + 1 < argc) databasePath = argv[++i];
+        else if (arg == "--custom" && i + 1 < argc) customPath = argv[++i];
+        else if (!arg.starts_with("-")) replayFiles.push_back(arg);
+        else {
+            printUsage();
+            return arg == "--help" || arg == "-h" ? EXIT_SUCCESS : 2;
+        }
+    }
+
+    if (!initializeState(state, databasePath, customPath, engineName)) {
+        return 2;
+    }
+
+    // Replay saved inputs first
+    for (const auto& path : replayFiles) {
+        std::ifstream input(path, std::ios::binary);
+        std::string text((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        checkInput(state, text);
+    }
+
+    // Alternate between fresh well-formed bodies and mutations of them
+    SyntheticRandom random(seed);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        std::string text = generateScriptText(random, state.regionCells, random.nextInt(1, 6));
+        if (random.chance(0.75)) {
+            text = mutateScript(random, std::move(text));
+        }
+        checkInput(state, text);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::format("{} inputs ({} vs reference), {} findings, {:.1f} s\n",
+        iterations + replayFiles.size(), state.candidate->name, state.findings, seconds);
+    return state.findings == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif
@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ab_coord_processor.h"
+#include "ab_database.h"
+#include "ab_engines.h"
+#include "ab_library.h"
+#include "ab_options.h"
+#include "ab_synthetic_corpus.h"
+
+// Golden-output regression harness: runs a corpus through the reference engine and a candidate engine,
+// compares the results structurally and textually, and optionally pins the reference output in golden files.
+
+// Structure for storing a single corpus document
+struct CorpusCase {
+    std::string name;
+    ordered_json document;
+};
+
+// Structure for storing the first divergence between two documents
+struct Divergence {
+    std::string path;
+    std::string detail;
+};
+
+// Helper function to make a short printable excerpt of a string around an offset
+static std::string excerpt(const std::string& text, size_t offset) {
+    size_t start = offset > 20 ? offset - 20 : 0;
+    std::string result;
+    for (size_t i = start; i < std::min(text.size(), offset + 20); ++i) {
+        char c = text[i];
+        if (c == '\r') result += "\\r";
+        else if (c == '\n') result += "\\n";
+        else result += c;
+    }
+    return "\"" + result + "\"";
+}
+
+// Function to find the first structural divergence (strings are compared byte-for-byte)
+static std::optional<Divergence> findFirstDivergence(const ordered_json& expected, const ordered_json& actual, const std::string& path) {
+    // Integers parsed back from a golden file may come back signed or unsigned, compare numbers by value
+    if (expected.type() != actual.type() && !(expected.is_number() && actual.is_number())) {
+        return Divergence{ path, std::format("type {} vs {}", expected.type_name(), actual.type_name()) };
+    }
+
+    if (expected.is_object()) {
+        auto expectedIter = expected.begin();
+        auto actualIter = actual.begin();
+        for (; expectedIter != expected.end() && actualIter != actual.end(); ++expectedIter, ++actualIter) {
+            if (expectedIter.key() != actualIter.key()) {
+                return Divergence{ path, std::format("key '{}' vs '{}'", expectedIter.key(), actualIter.key()) };
+            }
+            if (auto divergence = findFirstDivergence(expectedIter.value(), actualIter.value(), path + "/" + expectedIter.key())) {
+                return divergence;
+            }
+        }
+        if (expected.size() != actual.size()) {
+            return Divergence{ path, std::format("{} keys vs {} keys", expected.size(), actual.size()) };
+        }
+        return std::nullopt;
+    }
+
+    if (expected.is_array()) {
+        for (size_t i = 0; i < std::min(expected.size(), actual.size()); ++i) {
+            if (auto divergence = findFirstDivergence(expected[i], actual[i], path + "/" + std::to_string(i))) {
+                return divergence;
+            }
+        }
+        if (expected.size() != actual.size()) {
+            return Divergence{ path, std::format("{} elements vs {} elements", expected.size(), actual.size()) };
+        }
+        return std::nullopt;
+    }
+
+    if (expected.is_string()) {
+        const std::string& expectedText = expected.get_ref<const std::string&>();
+        const std::string& actualText = actual.get_ref<const std::string&>();
+        if (expectedText == actualText) {
+            return std::nullopt;
+        }
+        auto mismatch = std::mismatch(expectedText.begin(), expectedText.end(), actualText.begin(), actualText.end());
+        size_t offset = static_cast<size_t>(mismatch.first - expectedText.begin());
+        return Divergence{ path, std::format("byte {}: {} vs {}", offset, excerpt(expectedText, offset), excerpt(actualText, offset)) };
+    }
+
+    if (expected != actual) {
+        return Divergence{ path, std::format("{} vs {}", expected.dump(), actual.dump()) };
+    }
+    return std::nullopt;
+}
+
+// Function to find the first differing line of the serialized documents, as tes3conv would receive them
+static std::optional<Divergence> findFirstTextDivergence(const ordered_json& expected, const ordered_json& actual) {
+    std::istringstream expectedLines(expected.dump(2));
+    std::istringstream actualLines(actual.dump(2));
+    std::string expectedLine, actualLine;
+
+    for (int line = 1;; ++line) {
+        bool hasExpected = static_cast<bool>(std::getline(expectedLines, expectedLine));
+        bool hasActual = static_cast<bool>(std::getline(actualLines, actualLine));
+        if (!hasExpected && !hasActual) {
+            return std::nullopt;
+        }
+        if (!hasExpected || !hasActual) {
+            return Divergence{ std::format("line {}", line), hasExpected ? "expected more lines" : "unexpected extra lines" };
+        }
+        if (expectedLine != actualLine) {
+            auto mismatch = std::mismatch(expectedLine.begin(), expectedLine.end(), actualLine.begin(), actualLine.end());
+            size_t column = static_cast<size_t>(mismatch.first - expectedLine.begin());
+            return Divergence{ std::format("line {}, column {}", line, column + 1), std::format("{} vs {}", excerpt(expectedLine, column), excerpt(actualLine, column)) };
+        }
+    }
+}
+
+// Function to run an engine over a copy of the document
+static ordered_json runEngine(const ConversionEngine& engine, const EngineContext& context, const ordered_json& document) {
+    ordered_json output = document;
+    int replacementsFlag = 0;
+    std::vector<std::string> updatedScriptIDs;
+    engine.run(context, output, replacementsFlag, updatedScriptIDs);
+    return output;
+}
+
+// Function to report the first divergence, returns true if the documents match
+static bool compareDocuments(const std::string& label, const ordered_json& expected, const ordered_json& actual) {
+    auto structural = findFirstDivergence(expected, actual, "");
+    auto textual = findFirstTextDivergence(expected, actual);
+    if (!structural && !textual) {
+        return true;
+    }
+
+    std::cout << "FAIL " << label << "\n";
+    if (structural) {
+        std::cout << "  structural: " << (structural->path.empty() ? "/" : structural->path) << " - " << structural->detail << "\n";
+    }
+    if (textual) {
+        std::cout << "  textual: " << textual->path << " - " << textual->detail << "\n";
+    }
+    return false;
+}
+
+// Function to print usage information
+static void printUsage() {
+    std::cout << "Usage: tes3_ab_golden [OPTIONS]\n\n"
+              << "Options:\n"
+              << "  --corpus <dir>       Directory with .JSON documents produced by tes3conv\n"
+              << "  --synthetic <count>  Number of generated synthetic documents (default 16)\n"
+              << "  --engine <name>      Candidate engine compared against the reference (default reference)\n"
+              << "  --golden <dir>       Directory with golden outputs of the reference engine (missing outputs fail)\n"
+              << "  --update             Rewrite the golden outputs instead of comparing them\n"
+              << "  --db <file>          Coordinate database (default tes3_ab_cell_x-y_data.db)\n"
+              << "  --custom <file>      Custom coordinates file (default tes3_ab_custom_cell_x-y_data.txt)\n\n"
+              << "Engines:";
+    for (const auto& engine : conversionEngines()) {
+        std::cout << " " << engine.name;
+    }
+    std::cout << "\n";
+}
+
+// Main function
+int main(int argc, char* argv[]) {
+    std::filesystem::path corpusDir, goldenDir;
+    std::string databasePath = "tes3_ab_cell_x-y_data.db";
+    std::string customPath = "tes3_ab_custom_cell_x-y_data.txt";
+    std::string engineName = "reference";
+    int syntheticCount = 16;
+    bool updateGolden = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--corpus" && i + 1 < argc) corpusDir = argv[++i];
+        else if (arg == "--synthetic" && i + 1 < argc) syntheticCount = std::atoi(argv[++i]);
+        else if (arg == "--engine" && i + 1 < argc) engineName = argv[++i];
+        else if (arg == "--golden" && i + 1 < argc) goldenDir = argv[++i];
+        else if (arg == "--update") updateGolden = true;
+        else if (arg == "--db" && i + 1 < argc) databasePath = argv[++i];
+        else if (arg == "--custom" && i + 1 < argc) customPath = argv[++i];
+        else {
+            printUsage();
+            return arg == "--help" || arg == "-h" ? EXIT_SUCCESS : 2;
+        }
+    }
+
+    const ConversionEngine* reference = &conversionEngines().front();
+    const ConversionEngine* candidate = findConversionEngine(engineName);
+    if (candidate == nullptr) {
+        std::cerr << "ERROR - unknown engine: " << engineName << "\n";
+        return 2;
+    }
+
+    if (!std::filesystem::exists(databasePath)) {
+        std::cerr << "ERROR - database file '" << databasePath << "' not found!\n";
+        return 2;
+    }
+    std::ofstream logFile("tes3_ab_golden.log", std::ios::trunc);
+    std::unordered_set<std::pair<int, int>, PairHash> customCoordinates;
+    if (std::filesystem::exists(customPath)) {
+        loadCustomGridCoordinates(customPath, customCoordinates, false, logFile);
+    }
+    CoordinateIndex index(Database(databasePath), std::move(customCoordinates));
+
+    // Collect the corpus: real documents first, then generated ones
+    std::vector<CorpusCase> corpus;
+    if (!corpusDir.empty()) {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(corpusDir)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".json") {
+                paths.push_back(entry.path());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+        for (const auto& path : paths) {
+            std::ifstream input(path, std::ios::binary);
+            ordered_json document = ordered_json::parse(input, nullptr, false);
+            if (document.is_discarded()) {
+                std::cerr << "WARNING - skipping invalid .JSON: " << path.string() << "\n";
+                continue;
+            }
+            corpus.push_back({ path.stem().string(), std::move(document) });
+        }
+    }
+
+    auto regionCells = loadRegionCells(databasePath);
+    for (int seed = 1; seed <= syntheticCount; ++seed) {
+        SyntheticPluginSpec spec;
+        spec.scriptLines = 8 + seed % 24;
+        corpus.push_back({ std::format("synthetic_{:04d}", seed), generateSyntheticPlugin(spec, regionCells, static_cast<std::uint32_t>(seed)) });
+    }
+
+    if (!goldenDir.empty() && updateGolden) {
+        std::filesystem::create_directories(goldenDir);
+    }
+
+    int failures = 0, checks = 0;
+    for (const auto& corpusCase : corpus) {
+        for (int conversionType : { 1, 2 }) {
+            ProgramOptions options;
+            options.silentMode = true;
+            options.conversionType = conversionType;
+            EngineContext context{ index, options, logFile };
+
+            std::string label = std::format("{} ({})", corpusCase.name, conversionType == 1 ? "BM->AB" : "AB->BM");
+            ordered_json referenceOutput = runEngine(*reference, context, corpusCase.document);
+
+            // Candidate engine against the reference
+            if (candidate != reference) {
+                ++checks;
+                ordered_json candidateOutput = runEngine(*candidate, context, corpusCase.document);
+                if (!compareDocuments(label + " [" + candidate->name + " vs reference]", referenceOutput, candidateOutput)) {
+                    ++failures;
+                }
+            }
+
+            // Reference against the pinned golden output
+            if (!goldenDir.empty()) {
+                std::filesystem::path goldenPath = goldenDir / std::format("{}.{}.json", corpusCase.name, conversionType == 1 ? "bm-ab" : "ab-bm");
+                if (updateGolden) {
+                    std::ofstream goldenFile(goldenPath, std::ios::binary);
+                    goldenFile << std::setw(2) << referenceOutput << "\n";
+                }
+                else if (std::filesystem::exists(goldenPath)) {
+                    ++checks;
+                    std::ifstream goldenFile(goldenPath, std::ios::binary);
+                    ordered_json goldenOutput = ordered_json::parse(goldenFile, nullptr, false);
+                    if (!compareDocuments(label + " [reference vs golden]", goldenOutput, referenceOutput)) {
+                        ++failures;
+                    }
+                }
+                else {
+                    std::cout << "MISSING golden output: " << goldenPath.string() << "\n";
+                    ++failures;
+                }
+            }
+        }
+    }
+
+    std::cout << std::format("{} documents, {} comparisons, {} divergent\n", corpus.size(), checks, failures);
+
+    // A run that compared nothing proves nothing (no candidate engine, no golden outputs)
+    if (checks == 0 && !updateGolden) {
+        std::cout << "ERROR - nothing was compared, pass --golden or --engine\n";
+        return EXIT_FAILURE;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,119 @@
+# Profile-guided build of the converter, run by the pgo target or directly:
+#   cmake -DBINARY_DIR=build/pgo -P Tools/tes3_ab_pgo.cmake
+#
+# 1. baseline:   Release build of the converter and the throughput harness
+# 2. corpus:     synthetic plugins written by the harness (TRAINING_FILES, TRAINING_MEDIAN_KB)
+# 3. instrument: converter built with TES3AB_PGO=generate
+# 4. train:      harness runs of the instrumented converter over the corpus (both conversions)
+# 5. optimize:   the same build directory rebuilt with TES3AB_PGO=use and link-time optimization
+# 6. compare:    harness runs of the baseline and the optimized converter (COMPARE_REPEAT, fastest kept)
+#
+# The optimized converter is in <BINARY_DIR>/optimized, the comparison in <BINARY_DIR>/pgo_comparison.json.
+
+cmake_minimum_required(VERSION 3.15)
+
+get_filename_component(TOOLS_DIR "${CMAKE_CURRENT_LIST_DIR}" ABSOLUTE)
+if(NOT SOURCE_DIR)
+    get_filename_component(SOURCE_DIR "${TOOLS_DIR}/.." ABSOLUTE)
+endif()
+if(NOT BINARY_DIR)
+    set(BINARY_DIR "${CMAKE_CURRENT_BINARY_DIR}/pgo")
+endif()
+get_filename_component(BINARY_DIR "${BINARY_DIR}" ABSOLUTE)
+if(NOT TRAINING_FILES)
+    set(TRAINING_FILES 300)
+endif()
+if(NOT TRAINING_MEDIAN_KB)
+    set(TRAINING_MEDIAN_KB 48)
+endif()
+if(NOT COMPARE_REPEAT)
+    set(COMPARE_REPEAT 3)
+endif()
+
+set(BASELINE_DIR "${BINARY_DIR}/baseline")
+set(OPTIMIZED_DIR "${BINARY_DIR}/optimized")
+set(PROFILE_DIR "${BINARY_DIR}/profile")
+set(CORPUS_DIR "${BINARY_DIR}/corpus")
+set(DATABASE_FILE "${SOURCE_DIR}/DB/tes3_ab_cell_x-y_data.db")
+set(CUSTOM_FILE "${SOURCE_DIR}/DB/tes3_ab_custom_cell_x-y_data.txt")
+
+# Helper function to run a command and stop on failure
+function(pgo_run description)
+    message(STATUS "PGO: ${description}")
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "PGO: ${description} failed (${result})")
+    endif()
+endfunction()
+
+# Helper function to configure a Release build directory and build the given targets
+function(pgo_build description buildDir)
+    cmake_parse_arguments(PGO "" "" "TARGETS;OPTIONS" ${ARGN})
+    set(configure -S "${SOURCE_DIR}" -B "${buildDir}" -DCMAKE_BUILD_TYPE=Release ${PGO_OPTIONS})
+    if(GENERATOR)
+        list(APPEND configure -G "${GENERATOR}")
+    endif()
+    if(CXX_COMPILER)
+        list(APPEND configure "-DCMAKE_CXX_COMPILER=${CXX_COMPILER}")
+    endif()
+    if(DEFINED CXX_FLAGS)
+        list(APPEND configure "-DCMAKE_CXX_FLAGS=${CXX_FLAGS}")
+    endif()
+    pgo_run("configure ${description}" "${CMAKE_COMMAND}" ${configure})
+    pgo_run("build ${description}" "${CMAKE_COMMAND}" --build "${buildDir}" --config Release --parallel --target ${PGO_TARGETS})
+endfunction()
+
+# Helper function to find a program built by a single- or multi-configuration generator
+function(pgo_find_program variable buildDir name)
+    if(CMAKE_HOST_WIN32)
+        set(name "${name}.exe")
+    endif()
+    foreach(candidate "${buildDir}/Release/${name}" "${buildDir}/${name}")
+        if(EXISTS "${candidate}")
+            set(${variable} "${candidate}" PARENT_SCOPE)
+            return()
+        endif()
+    endforeach()
+    message(FATAL_ERROR "PGO: ${name} not found in ${buildDir}")
+endfunction()
+
+# 1. Baseline converter, harness and tes3conv stand-in
+pgo_build("baseline" "${BASELINE_DIR}"
+    TARGETS tes3_ab_converter tes3_ab_throughput fake_tes3conv
+    OPTIONS -DTES3AB_BUILD_TOOLS=ON -DTES3AB_PGO=)
+pgo_find_program(BASELINE_CONVERTER "${BASELINE_DIR}" tes3_ab_converter)
+pgo_find_program(HARNESS "${BASELINE_DIR}" tes3_ab_throughput)
+pgo_find_program(FAKE_TES3CONV "${BASELINE_DIR}" fake_tes3conv)
+
+# 2. Training corpus (the same seed gives the same plugins)
+file(REMOVE_RECURSE "${CORPUS_DIR}")
+pgo_run("generate ${TRAINING_FILES} training plugins" "${HARNESS}" generate --out "${CORPUS_DIR}" --files ${TRAINING_FILES}
+    --median-kb ${TRAINING_MEDIAN_KB} --db "${DATABASE_FILE}")
+
+# 3. Instrumented converter; stale profiles would be merged into the new one
+file(REMOVE_RECURSE "${PROFILE_DIR}")
+pgo_build("instrumented converter" "${OPTIMIZED_DIR}"
+    TARGETS tes3_ab_converter
+    OPTIONS -DTES3AB_BUILD_TOOLS=OFF -DTES3AB_PGO=generate "-DTES3AB_PGO_DIR=${PROFILE_DIR}")
+pgo_find_program(INSTRUMENTED_CONVERTER "${OPTIMIZED_DIR}" tes3_ab_converter)
+
+# 4. Training runs
+set(HARNESS_RUN "${HARNESS}" run --corpus "${CORPUS_DIR}" --tes3conv "${FAKE_TES3CONV}" --db "${DATABASE_FILE}"
+    --custom "${CUSTOM_FILE}" --work "${BINARY_DIR}/work" --jobs 1)
+foreach(conversion 1 2)
+    pgo_run("train conversion ${conversion}" ${HARNESS_RUN} --converter "${INSTRUMENTED_CONVERTER}" --conversion ${conversion})
+endforeach()
+
+# 5. Optimized converter
+pgo_build("optimized converter" "${OPTIMIZED_DIR}"
+    TARGETS tes3_ab_converter
+    OPTIONS -DTES3AB_PGO=use)
+pgo_find_program(OPTIMIZED_CONVERTER "${OPTIMIZED_DIR}" tes3_ab_converter)
+
+# 6. Comparison on the harness
+pgo_run("compare with the baseline" ${HARNESS_RUN} --converter "${OPTIMIZED_CONVERTER}" --baseline "${BASELINE_CONVERTER}"
+    --repeat ${COMPARE_REPEAT} --output "${BINARY_DIR}/pgo_comparison.json")
+file(REMOVE_RECURSE "${BINARY_DIR}/work")
+
+message(STATUS "PGO: optimized converter: ${OPTIMIZED_CONVERTER}")
+message(STATUS "PGO: comparison: ${BINARY_DIR}/pgo_comparison.json")
@@ -0,0 +1,395 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ab_options.h"
+#include "ab_process.h"
+#include "ab_synthetic_corpus.h"
+
+// End-to-end throughput harness: generates directory trees of synthetic plugins and runs the converter
+// over them at 1..N concurrent jobs against a local tes3conv stand-in (fake_tes3conv).
+//
+// Each job is a separate converter process with its own working directory (database, custom coordinates,
+// tes3conv and log are looked up there) and its own share of the files, balanced by size.
+
+// Structure for storing a plugin of the corpus
+struct CorpusFile {
+    std::filesystem::path relativePath;
+    std::uintmax_t bytes = 0;
+};
+
+// Structure for storing the result of one job count
+struct ThroughputResult {
+    int jobs = 0;
+    double wallSeconds = 0.0;
+    double filesPerSecond = 0.0;
+    double megabytesPerSecond = 0.0;
+    double speedup = 0.0;
+    double efficiency = 0.0;
+    int converted = 0;
+    int failedJobs = 0;
+    ChildUsage usage;
+    double baselineWallSeconds = 0.0; // with --baseline: the same run with the baseline converter
+};
+
+// Structure for storing what every run of the harness shares
+struct ThroughputSetup {
+    std::filesystem::path corpusDir;
+    std::filesystem::path workDir;
+    std::filesystem::path tes3convPath;
+    std::filesystem::path databasePath;
+    std::filesystem::path customPath;
+    int conversionType = 1;
+};
+
+// Helper function to set a variable in the environment inherited by the converter and tes3conv
+static void setEnvironment(const char* name, double value) {
+    std::string text = std::format("{}", value);
+#ifdef _WIN32
+    _putenv_s(name, text.c_str());
+#else
+    setenv(name, text.c_str(), 1);
+#endif
+}
+
+// Helper function to parse a comma-separated list of job counts
+static std::vector<int> parseJobCounts(const std::string& text) {
+    std::vector<int> counts;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int count = std::atoi(item.c_str());
+        if (count > 0) counts.push_back(count);
+    }
+    return counts;
+}
+
+// Function to generate a tree of synthetic plugins with a log-normal size distribution
+// (most plugins are small, a few are several MB, like a real Data Files folder)
+static int generateCorpus(const std::filesystem::path& outputDir, int fileCount, double medianKB, std::uint32_t seed, const std::string& databasePath) {
+    auto regionCells = loadRegionCells(databasePath);
+    if (regionCells.empty()) {
+        std::cerr << "ERROR - no grid cells found in '" << databasePath << "'\n";
+        return 2;
+    }
+
+    SyntheticRandom random(seed);
+    std::uintmax_t totalBytes = 0;
+    std::filesystem::create_directories(outputDir);
+
+    for (int i = 0; i < fileCount; ++i) {
+        // Box-Muller keeps the sequence identical on every standard library
+        double u1 = std::max(random.nextReal(0.0, 1.0), 1e-12);
+        double u2 = random.nextReal(0.0, 1.0);
+        double normal = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+        double targetKB = std::clamp(medianKB * std::exp(1.2 * normal), 4.0, 16384.0);
+
+        // Roughly 6 KB of .JSON per generated exterior cell with its references
+        SyntheticPluginSpec spec;
+        spec.exteriorCells = std::max(1, static_cast<int>(targetKB / 6.0));
+        spec.referencesPerCell = 20;
+        spec.interiorCells = spec.exteriorCells / 8;
+        spec.npcs = spec.exteriorCells / 8;
+        spec.scripts = std::max(1, spec.exteriorCells / 16);
+        spec.dialogues = spec.exteriorCells / 16;
+
+        std::filesystem::path directory = outputDir / std::format("Mod_{:03d}", i / 50);
+        std::filesystem::create_directories(directory);
+        std::filesystem::path path = directory / std::format("synthetic_{:05d}.esp", i);
+
+        std::ofstream output(path, std::ios::binary);
+        output << generateSyntheticPlugin(spec, regionCells, seed * 100003u + static_cast<std::uint32_t>(i)).dump(2);
+        output.close();
+        totalBytes += std::filesystem::file_size(path);
+    }
+
+    std::cout << std::format("Generated {} plugins, {:.1f} MB in {}\n", fileCount, totalBytes / (1024.0 * 1024.0), outputDir.string());
+    return EXIT_SUCCESS;
+}
+
+// Function to collect the plugins of a corpus tree
+static std::vector<CorpusFile> collectCorpus(const std::filesystem::path& corpusDir) {
+    std::vector<CorpusFile> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(corpusDir)) {
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (entry.is_regular_file() && (extension == ".esp" || extension == ".esm")) {
+            files.push_back({ std::filesystem::relative(entry.path(), corpusDir), entry.file_size() });
+        }
+    }
+    return files;
+}
+
+// Function to split the files into shards of similar total size (largest first, onto the lightest shard)
+static std::vector<std::vector<const CorpusFile*>> partitionFiles(const std::vector<CorpusFile>& files, int jobs) {
+    std::vector<const CorpusFile*> sorted;
+    for (const auto& file : files) sorted.push_back(&file);
+    std::sort(sorted.begin(), sorted.end(), [](const CorpusFile* a, const CorpusFile* b) { return a->bytes > b->bytes; });
+
+    std::vector<std::vector<const CorpusFile*>> shards(jobs);
+    std::vector<std::uintmax_t> load(jobs, 0);
+    for (const CorpusFile* file : sorted) {
+        size_t lightest = static_cast<size_t>(std::min_element(load.begin(), load.end()) - load.begin());
+        shards[lightest].push_back(file);
+        load[lightest] += file->bytes;
+    }
+    return shards;
+}
+
+// Function to count converted files in a job report written with --report
+static int countConverted(const std::filesystem::path& reportPath) {
+    std::ifstream input(reportPath, std::ios::binary);
+    ordered_json report = ordered_json::parse(input, nullptr, false);
+    if (report.is_discarded() || !report.contains("files")) {
+        return 0;
+    }
+    return static_cast<int>(std::count_if(report["files"].begin(), report["files"].end(),
+        [](const ordered_json& file) { return file.value("status", "") == "converted"; }));
+}
+
+// Function to run the converter over copies of the corpus with the given number of concurrent jobs
+static ThroughputResult measureJobs(const ThroughputSetup& setup, const std::vector<CorpusFile>& files,
+    const std::filesystem::path& converterPath, int jobs) {
+    // Fresh copy of the corpus for every run, the converter rewrites plugins in place
+    const std::string tes3convName = std::filesystem::path(TES3CONV_COMMAND).filename().string();
+    std::filesystem::path runDir = setup.workDir / std::format("jobs_{}", jobs);
+    std::filesystem::remove_all(runDir);
+
+    auto shards = partitionFiles(files, jobs);
+    std::vector<std::filesystem::path> jobDirs;
+    for (int job = 0; job < jobs; ++job) {
+        std::filesystem::path jobDir = runDir / std::format("job_{}", job);
+        std::filesystem::create_directories(jobDir / "plugins");
+        std::filesystem::copy_file(setup.databasePath, jobDir / setup.databasePath.filename());
+        std::filesystem::copy_file(setup.customPath, jobDir / setup.customPath.filename());
+        std::filesystem::copy_file(setup.tes3convPath, jobDir / tes3convName);
+        for (const CorpusFile* file : shards[job]) {
+            std::filesystem::path target = jobDir / "plugins" / file->relativePath;
+            std::filesystem::create_directories(target.parent_path());
+            std::filesystem::copy_file(setup.corpusDir / file->relativePath, target);
+        }
+        jobDirs.push_back(std::filesystem::absolute(jobDir));
+    }
+
+    // Launch all jobs at once and wait for the slowest
+    std::vector<ProcessResult> processResults(jobs);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int job = 0; job < jobs; ++job) {
+        threads.emplace_back([&, job] {
+            processResults[job] = runProcess({ converterPath.string(), "-b", "-s", setup.conversionType == 1 ? "-1" : "-2",
+                "--report", "report.json", "plugins" }, jobDirs[job], jobDirs[job] / "console.log");
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ThroughputResult result;
+    result.jobs = jobs;
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (int job = 0; job < jobs; ++job) {
+        if (!processResults[job].started || processResults[job].exitCode != 0) {
+            ++result.failedJobs;
+        }
+        result.usage += processResults[job].usage;
+        result.converted += countConverted(jobDirs[job] / "report.json");
+    }
+    return result;
+}
+
+// Function to print usage information
+static void printUsage() {
+    std::cout << "Usage:\n"
+              << "  tes3_ab_throughput generate --out <dir> [--files <count>] [--median-kb <size>] [--seed <number>] [--db <file>]\n"
+              << "  tes3_ab_throughput run --corpus <dir> --converter <file> --tes3conv <file> [OPTIONS]\n\n"
+              << "Run options:\n"
+              << "  --jobs <list>         Concurrent converter processes to measure (default 1,2,4)\n"
+              << "  --work <dir>          Scratch directory, recreated for every job count (default throughput_work)\n"
+              << "  --conversion <1|2>    Conversion type passed to the converter (default 1)\n"
+              << "  --latency-ms <ms>     Idle time of each fake tes3conv run (default 0)\n"
+              << "  --cpu-ms <ms>         Busy time of each fake tes3conv run (default 0)\n"
+              << "  --cpu-ms-per-mb <ms>  Additional busy time per MB of tes3conv input (default 0)\n"
+              << "  --db <file>           Coordinate database (default tes3_ab_cell_x-y_data.db)\n"
+              << "  --custom <file>       Custom coordinates file (default tes3_ab_custom_cell_x-y_data.txt)\n"
+              << "  --output <file>       Write the results as .JSON\n"
+              << "  --baseline <file>     Also run this converter on the same corpus and report the speedup over it\n"
+              << "  --repeat <n>          Measure every run n times and keep the fastest (default 1)\n";
+}
+
+// Main function
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 2;
+    }
+
+    std::string mode = argv[1];
+    std::filesystem::path outputDir, corpusDir, converterPath, tes3convPath, resultsPath, baselinePath;
+    std::filesystem::path workDir = "throughput_work";
+    std::filesystem::path databasePath = "tes3_ab_cell_x-y_data.db";
+    std::filesystem::path customPath = "tes3_ab_custom_cell_x-y_data.txt";
+    std::vector<int> jobCounts = { 1, 2, 4 };
+    int fileCount = 1000, conversionType = 1, repeat = 1;
+    double medianKB = 48.0, latency = 0.0, cpu = 0.0, cpuPerMB = 0.0;
+    std::uint32_t seed = 1;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) outputDir = argv[++i];
+        else if (arg == "--files" && i + 1 < argc) fileCount = std::atoi(argv[++i]);
+        else if (arg == "--median-kb" && i + 1 < argc) medianKB = std::atof(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--corpus" && i + 1 < argc) corpusDir = argv[++i];
+        else if (arg == "--converter" && i + 1 < argc) converterPath = argv[++i];
+        else if (arg == "--tes3conv" && i + 1 < argc) tes3convPath = argv[++i];
+        else if (arg == "--jobs" && i + 1 < argc) jobCounts = parseJobCounts(argv[++i]);
+        else if (arg == "--work" && i + 1 < argc) workDir = argv[++i];
+        else if (arg == "--conversion" && i + 1 < argc) conversionType = std::atoi(argv[++i]) == 2 ? 2 : 1;
+        else if (arg == "--latency-ms" && i + 1 < argc) latency = std::atof(argv[++i]);
+        else if (arg == "--cpu-ms" && i + 1 < argc) cpu = std::atof(argv[++i]);
+        else if (arg == "--cpu-ms-per-mb" && i + 1 < argc) cpuPerMB = std::atof(argv[++i]);
+        else if (arg == "--db" && i + 1 < argc) databasePath = argv[++i];
+        else if (arg == "--custom" && i + 1 < argc) customPath = argv[++i];
+        else if (arg == "--output" && i + 1 < argc) resultsPath = argv[++i];
+        else if (arg == "--baseline" && i + 1 < argc) baselinePath = argv[++i];
+        else if (arg == "--repeat" && i + 1 < argc) repeat = std::max(1, std::atoi(argv[++i]));
+        else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (mode == "generate") {
+        if (outputDir.empty() || fileCount <= 0) {
+            printUsage();
+            return 2;
+        }
+        return generateCorpus(outputDir, fileCount, medianKB, seed, databasePath.string());
+    }
+
+    if (mode != "run" || corpusDir.empty() || converterPath.empty() || tes3convPath.empty() || jobCounts.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    for (const auto& required : { corpusDir, converterPath, tes3convPath, databasePath, customPath }) {
+        if (!std::filesystem::exists(required)) {
+            std::cerr << "ERROR - '" << required.string() << "' not found!\n";
+            return 2;
+        }
+    }
+    converterPath = std::filesystem::absolute(converterPath);
+    if (!baselinePath.empty()) {
+        if (!std::filesystem::exists(baselinePath)) {
+            std::cerr << "ERROR - '" << baselinePath.string() << "' not found!\n";
+            return 2;
+        }
+        baselinePath = std::filesystem::absolute(baselinePath);
+    }
+
+    std::vector<CorpusFile> files = collectCorpus(corpusDir);
+    if (files.empty()) {
+        std::cerr << "ERROR - no .ESP|ESM files in '" << corpusDir.string() << "'\n";
+        return 2;
+    }
+    std::uintmax_t totalBytes = 0;
+    for (const auto& file : files) totalBytes += file.bytes;
+    double totalMB = totalBytes / (1024.0 * 1024.0);
+
+    setEnvironment("TES3AB_FAKE_LATENCY_MS", latency);
+    setEnvironment("TES3AB_FAKE_CPU_MS", cpu);
+    setEnvironment("TES3AB_FAKE_CPU_MS_PER_MB", cpuPerMB);
+
+    std::cout << std::format("{} plugins, {:.1f} MB, tes3conv latency {} ms, cpu {} ms + {} ms/MB, {} hardware threads\n\n",
+        files.size(), totalMB, latency, cpu, cpuPerMB, std::thread::hardware_concurrency());
+    std::cout << std::format("{:>5} {:>10} {:>10} {:>9} {:>8} {:>11} {:>10}", "jobs", "wall s", "files/s", "MB/s", "speedup", "efficiency", "converted");
+    std::cout << (baselinePath.empty() ? std::string() : std::format(" {:>10} {:>12}", "baseline s", "vs baseline")) << "\n";
+
+    ThroughputSetup setup{ corpusDir, workDir, tes3convPath, databasePath, customPath, conversionType };
+    std::vector<ThroughputResult> results;
+    for (int jobs : jobCounts) {
+        // Fastest of the repeated runs; with a baseline both converters alternate on the same machine state
+        ThroughputResult result;
+        int baselineFailedJobs = 0;
+        for (int run = 0; run < repeat; ++run) {
+            double baselineWall = 0.0;
+            if (!baselinePath.empty()) {
+                ThroughputResult baseline = measureJobs(setup, files, baselinePath, jobs);
+                baselineWall = baseline.wallSeconds;
+                baselineFailedJobs += baseline.failedJobs;
+            }
+            ThroughputResult measured = measureJobs(setup, files, converterPath, jobs);
+            if (run == 0 || measured.wallSeconds < result.wallSeconds) {
+                measured.baselineWallSeconds = result.baselineWallSeconds;
+                result = measured;
+            }
+            if (run == 0 || baselineWall < result.baselineWallSeconds) {
+                result.baselineWallSeconds = baselineWall;
+            }
+        }
+        result.failedJobs += baselineFailedJobs;
+        result.filesPerSecond = files.size() / result.wallSeconds;
+        result.megabytesPerSecond = totalMB / result.wallSeconds;
+
+        // Scaling relative to the first (smallest) job count
+        const ThroughputResult& base = results.empty() ? result : results.front();
+        result.speedup = base.wallSeconds / result.wallSeconds;
+        result.efficiency = result.speedup * base.jobs / jobs;
+        results.push_back(result);
+
+        std::cout << std::format("{:>5} {:>10.2f} {:>10.1f} {:>9.2f} {:>7.2f}x {:>10.0f}% {:>10}", jobs, result.wallSeconds,
+            result.filesPerSecond, result.megabytesPerSecond, result.speedup, result.efficiency * 100.0, result.converted);
+        if (!baselinePath.empty()) {
+            std::cout << std::format(" {:>10.2f} {:>11.2f}x", result.baselineWallSeconds, result.baselineWallSeconds / result.wallSeconds);
+        }
+        std::cout << (result.failedJobs > 0 ? std::format("  ({} jobs failed)", result.failedJobs) : "") << "\n";
+    }
+
+    if (!resultsPath.empty()) {
+        ordered_json output;
+        output["files"] = files.size();
+        output["input_bytes"] = totalBytes;
+        output["tes3conv"] = { { "latency_ms", latency }, { "cpu_ms", cpu }, { "cpu_ms_per_mb", cpuPerMB } };
+        output["hardware_threads"] = std::thread::hardware_concurrency();
+        output["repeat"] = repeat;
+        if (!baselinePath.empty()) {
+            output["baseline"] = baselinePath.string();
+        }
+        output["runs"] = ordered_json::array();
+        for (const auto& result : results) {
+            output["runs"].push_back({
+                { "jobs", result.jobs },
+                { "wall_seconds", result.wallSeconds },
+                { "files_per_second", result.filesPerSecond },
+                { "mb_per_second", result.megabytesPerSecond },
+                { "speedup", result.speedup },
+                { "efficiency", result.efficiency },
+                { "converted", result.converted },
+                { "failed_jobs", result.failedJobs },
+                { "converter_user_seconds", result.usage.userSeconds },
+                { "converter_system_seconds", result.usage.systemSeconds },
+                { "converter_max_rss_kb", result.usage.maxRssKB },
+            });
+            if (!baselinePath.empty()) {
+                output["runs"].back()["baseline_wall_seconds"] = result.baselineWallSeconds;
+                output["runs"].back()["baseline_speedup"] = result.baselineWallSeconds / result.wallSeconds;
+            }
+        }
+        std::ofstream resultsFile(resultsPath, std::ios::binary);
+        resultsFile << output.dump(2) << "\n";
+    }
+
+    bool failed = std::any_of(results.begin(), results.end(), [](const ThroughputResult& result) { return result.failedJobs > 0; });
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}